@@ -0,0 +1,122 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+#include "AIDecisionTrace.h"
+#include "BattlescapeGame.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Options.h"
+#include "../Mod/RuleItem.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/BattleUnit.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+const char *_phaseNames[AIT_PHASES] = { "reachability", "targets", "cover", "fireMode", "psi", "grenade" };
+
+const char *_actionNames[] = {
+	"none", "turn", "walk", "kneel", "prime", "unprime", "throw", "autoshot", "snapshot", "aimedshot", "hit",
+	"use", "launch", "mindcontrol", "panic", "rethink", "cqb", "triggerTimedGrenade", "triggerProxyGrenade", "selfDestruct", "wait"
+};
+
+/**
+ * Gets the trace file, opening it on first use.
+ * The file is rewritten on every launch.
+ */
+std::ofstream &getTraceFile()
+{
+	static std::ofstream file;
+	if (!file.is_open())
+	{
+		std::string filename = Options::getUserFolder() + "aitrace.jsonl";
+		file.open(filename, std::ios::out | std::ios::trunc);
+		Log(LOG_INFO) << "Writing AI decision trace to: " << filename;
+	}
+	return file;
+}
+
+/**
+ * Writes a position as a JSON array.
+ */
+void writePosition(std::ostream &out, Position pos)
+{
+	out << '[' << pos.x << ',' << pos.y << ',' << pos.z << ']';
+}
+
+}
+
+/**
+ * Starts tracing a decision.
+ * @param slot Where the AI keeps the current trace, so the phases can reach it; cleared again when the trace ends.
+ * @param unit The deciding unit.
+ * @param action The action being decided, written as it is when the trace ends.
+ * @param turn The current turn.
+ */
+AIDecisionTrace::AIDecisionTrace(AIDecisionTrace *&slot, BattleUnit *unit, const BattleAction *action, int turn) :
+	_slot(slot), _unit(unit), _action(action), _turn(turn), _start(Profiler::now()), _times(), _calls(), _candidates(), _outOfTime(false)
+{
+	_slot = this;
+}
+
+/**
+ * Writes the decision to the trace file as one JSON line.
+ */
+AIDecisionTrace::~AIDecisionTrace()
+{
+	_slot = nullptr;
+	Uint64 total = Profiler::now() - _start;
+	std::ofstream &out = getTraceFile();
+	if (!out)
+	{
+		return;
+	}
+	out << "{\"turn\":" << _turn << ",\"unit\":" << _unit->getId() << ",\"type\":";
+	Profiler::writeJsonString(out, _unit->getType());
+	out << ",\"pos\":";
+	writePosition(out, _unit->getPosition());
+	out << ",\"us\":" << total << ",\"outOfTime\":" << (_outOfTime ? "true" : "false") << ",\"phases\":{";
+	for (int i = 0; i < AIT_PHASES; ++i)
+	{
+		if (i > 0) out << ',';
+		out << '"' << _phaseNames[i] << "\":{\"us\":" << _times[i] << ",\"calls\":" << _calls[i] << ",\"candidates\":" << _candidates[i] << '}';
+	}
+	out << "},\"action\":{\"type\":";
+	if (_action->type < sizeof(_actionNames) / sizeof(_actionNames[0]))
+	{
+		out << '"' << _actionNames[_action->type] << '"';
+	}
+	else
+	{
+		out << (int)_action->type;
+	}
+	out << ",\"target\":";
+	writePosition(out, _action->target);
+	if (_action->weapon)
+	{
+		out << ",\"weapon\":";
+		Profiler::writeJsonString(out, _action->weapon->getRules()->getType());
+	}
+	out << ",\"tu\":" << _unit->getTimeUnits() << "}}\n";
+	out.flush();
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <SDL_types.h>
+#include "../Engine/Profiler.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+struct BattleAction;
+
+/**
+ * Phases of a brutal AI decision.
+ */
+enum AITracePhase { AIT_REACHABILITY, AIT_TARGETS, AIT_COVER, AIT_FIRE_MODE, AIT_PSI, AIT_GRENADE, AIT_PHASES };
+
+/**
+ * Structured trace of one brutal AI decision.
+ * Each decision is written as one JSON line to aitrace.jsonl in the user folder,
+ * with the time spent and the candidates looked at in each phase, and the chosen action.
+ * Phases can nest, so their times include the phases nested in them.
+ */
+class AIDecisionTrace
+{
+	AIDecisionTrace *&_slot;
+	BattleUnit *_unit;
+	const BattleAction *_action;
+	int _turn;
+	Uint64 _start;
+	Uint64 _times[AIT_PHASES];
+	int _calls[AIT_PHASES], _candidates[AIT_PHASES];
+	bool _outOfTime;
+
+public:
+	/// Starts tracing a decision, making it reachable through the slot.
+	AIDecisionTrace(AIDecisionTrace *&slot, BattleUnit *unit, const BattleAction *action, int turn);
+	/// Writes the decision to the trace file.
+	~AIDecisionTrace();
+
+	AIDecisionTrace(const AIDecisionTrace&) = delete;
+	AIDecisionTrace& operator=(const AIDecisionTrace&) = delete;
+
+	/// Adds time spent in a phase.
+	void addTime(AITracePhase phase, Uint64 duration) { _times[phase] += duration; ++_calls[phase]; }
+	/// Adds candidates looked at in a phase.
+	void addCandidates(AITracePhase phase, int count) { _candidates[phase] += count; }
+	/// Marks the decision as cut short by the time budget.
+	void setOutOfTime() { _outOfTime = true; }
+};
+
+/**
+ * Measures the time spent in a scope and adds it to a phase
+ * of the traced decision. Does nothing if there is no trace.
+ */
+class AITraceScope
+{
+	AIDecisionTrace *_trace;
+	AITracePhase _phase;
+	Uint64 _start;
+
+public:
+	/// Starts measuring.
+	AITraceScope(AIDecisionTrace *trace, AITracePhase phase) : _trace(trace), _phase(phase), _start(trace ? Profiler::now() : 0)
+	{
+	}
+	/// Ends measuring.
+	~AITraceScope()
+	{
+		if (_trace)
+		{
+			_trace->addTime(_phase, Profiler::now() - _start);
+		}
+	}
+
+	AITraceScope(const AITraceScope&) = delete;
+	AITraceScope& operator=(const AITraceScope&) = delete;
+};
+
+}
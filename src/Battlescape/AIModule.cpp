@@ -18,7 +18,10 @@
  */
 #include <climits>
 #include <algorithm>
+#include <optional>
 #include "AIModule.h"
+#include "AIPlanner.h"
+#include "AIDecisionTrace.h"
 #include "../Savegame/BattleItem.h"
 #include "../Savegame/Node.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -29,6 +32,7 @@
 #include "Pathfinding.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
 #include "../Engine/Game.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
@@ -39,6 +43,20 @@
 namespace OpenXcom
 {
 
+namespace
+{
+
+/// Counters of the brutal AI time budget, for tuning it.
+struct BrutalBudgetStats
+{
+	int decisions = 0;
+	int hits = 0;
+	Uint64 tilesEvaluated = 0;
+	Uint64 tilesSkipped = 0;
+};
+BrutalBudgetStats brutalBudgetStats;
+
+}
 
 /**
  * Sets up a BattleAIState.
@@ -49,7 +67,8 @@ namespace OpenXcom
 AIModule::AIModule(SavedBattleGame *save, BattleUnit *unit, Node *node) :
 	_save(save), _unit(unit), _aggroTarget(0), _knownEnemies(0), _visibleEnemies(0), _spottingEnemies(0),
     _escapeTUs(0), _ambushTUs(0), _weaponPickedUp(false), _wantToEndTurn(false), _rifle(false), _melee(false), _blaster(false), _grenade(false), _ranOutOfTUs(false),
-	_didPsi(false), _AIMode(AI_PATROL), _closestDist(100), _fromNode(node), _toNode(0), _foundBaseModuleToDestroy(false)
+	_didPsi(false), _AIMode(AI_PATROL), _closestDist(100), _fromNode(node), _toNode(0), _foundBaseModuleToDestroy(false),
+	_thinkDeadline(0), _outOfTime(false), _trace(nullptr)
 {
 	_traceAI = Options::traceAI;
 
@@ -2874,6 +2893,13 @@ bool AIModule::visibleToAnyFriend(BattleUnit* target) const
 
 void AIModule::brutalThink(BattleAction* action)
 {
+	std::optional<AIDecisionTrace> trace;
+	if (Options::oxceAIDecisionTrace)
+		trace.emplace(_trace, _unit, action, _save->getTurn());
+	startThinkBudget();
+	if (_save->getBattleGame()->getAIPlanner())
+		_save->getBattleGame()->getAIPlanner()->startDecision();
+
 	// Step 1: Check whether we wait for someone else on our team to move first
 	int myReachable = getReachableBy(_unit, _ranOutOfTUs, true).size();
 	float myDist = 0;
@@ -2998,7 +3024,14 @@ void AIModule::brutalThink(BattleAction* action)
 	BattleActionMove bam = BAM_NORMAL;
 	if (Options::strafe && wantToRun())
 		bam = BAM_RUN;
+	Uint64 traceStart = _trace ? Profiler::now() : 0;
 	_allPathFindingNodes = _save->getPathfinding()->findReachablePathFindingNodes(_unit, BattleActionCost(), dummy, true, NULL, NULL, false, false, bam);
+	if (_trace)
+	{
+		_trace->addTime(AIT_REACHABILITY, Profiler::now() - traceStart);
+		_trace->addCandidates(AIT_REACHABILITY, _allPathFindingNodes.size());
+		traceStart = Profiler::now();
+	}
 	BattleUnit* unitToFaceTo = NULL;
 
 	float shortestDist = FLT_MAX;
@@ -3013,10 +3046,12 @@ void AIModule::brutalThink(BattleAction* action)
 	float targetDistanceTofurthestReach = FLT_MAX;
 	std::map<Position, int, PositionComparator> enemyReachable;
 	bool immobileEnemies = false;
+	int targetsConsidered = 0;
 	for (BattleUnit* target : *(_save->getUnits()))
 	{
 		if (target->isOut())
 			continue;
+		++targetsConsidered;
 		if (!_unit->isCheatOnMovement())
 		{
 			if (target->getTileLastSpotted(_unit->getFaction()) == -1)
@@ -3098,7 +3133,8 @@ void AIModule::brutalThink(BattleAction* action)
 				}
 			}
 		}
-		if (!target->hasPanickedLastTurn())
+		// flooding the reach of every target is the expensive part, once out of time the remaining targets only count by their position
+		if (!target->hasPanickedLastTurn() && !outOfTime())
 		{
 			for (auto& reachablePosOfTarget : getReachableBy(target, _ranOutOfTUs, false, true))
 			{
@@ -3123,6 +3159,11 @@ void AIModule::brutalThink(BattleAction* action)
 			unitToWalkTo = target;
 		}
 	}
+	if (_trace)
+	{
+		_trace->addTime(AIT_TARGETS, Profiler::now() - traceStart);
+		_trace->addCandidates(AIT_TARGETS, targetsConsidered);
+	}
 
 	// Phase 1: Check if you can attack anything from where you currently are
 	_attackAction.type = BA_RETHINK;
@@ -3420,8 +3461,20 @@ void AIModule::brutalThink(BattleAction* action)
 		}
 		float myTuDistFromTarget = tuCostToReachPosition(_positionAtStartOfTurn, targetNodes, NULL, true);
 		float myWalkToDist = myMaxTU + myTuDistFromTarget;
+		// the nodes are sorted by TU cost, so when time runs out the nearest tiles have been scored,
+		// the first one being the tile the unit stands on, which is always scored
+		size_t tilesLeft = _allPathFindingNodes.size();
+		traceStart = _trace ? Profiler::now() : 0;
 		for (auto pu : _allPathFindingNodes)
 		{
+			if (tilesLeft < _allPathFindingNodes.size() && outOfTime())
+			{
+				brutalBudgetStats.tilesSkipped += tilesLeft;
+				break;
+			}
+			--tilesLeft;
+			if (_thinkDeadline)
+				++brutalBudgetStats.tilesEvaluated;
 			Position pos = pu->getPosition();
 			Tile* tile = _save->getTile(pos);
 			if (tile == NULL)
@@ -3817,6 +3870,11 @@ void AIModule::brutalThink(BattleAction* action)
 			//	tile->setTUMarker(tile->getLastExplored(_myFaction));
 			//}
 		}
+		if (_trace)
+		{
+			_trace->addTime(AIT_COVER, Profiler::now() - traceStart);
+			_trace->addCandidates(AIT_COVER, _allPathFindingNodes.size() - tilesLeft);
+		}
 		if (_traceAI)
 		{
 			if (bestAttackScore > 0)
@@ -4454,6 +4512,7 @@ bool AIModule::isPathToPositionSave(Position target, bool &saveForProxies)
 
 bool AIModule::brutalPsiAction()
 {
+	AITraceScope traceScope(_trace, AIT_PSI);
 	BattleItem *item = _unit->getUtilityWeapon(BT_PSIAMP);
 	if (!item)
 	{
@@ -4512,6 +4571,8 @@ bool AIModule::brutalPsiAction()
 				{
 					continue;
 				}
+				if (_trace)
+					_trace->addCandidates(AIT_PSI, 1);
 				for (int j = 0; j < costLength; ++j)
 				{
 					// can't use this attack.
@@ -4586,6 +4647,7 @@ bool AIModule::brutalPsiAction()
 
 float AIModule::brutalExtendedFireModeChoice(BattleActionCost &costAuto, BattleActionCost &costSnap, BattleActionCost &costAimed, BattleActionCost &costThrow, BattleActionCost &costHit, bool checkLOF, float previousHighScore)
 {
+	AITraceScope traceScope(_trace, AIT_FIRE_MODE);
 	std::vector<BattleActionType> attackOptions = {};
 	if (!_unit->isLeeroyJenkins())
 	{
@@ -4702,6 +4764,8 @@ float AIModule::brutalExtendedFireModeChoice(BattleActionCost &costAuto, BattleA
  */
 float AIModule::brutalScoreFiringMode(BattleAction* action, BattleUnit* target, bool checkLOF, Tile* simulationTile, bool needToHideAfterwards)
 {
+	if (_trace)
+		_trace->addCandidates(AIT_FIRE_MODE, 1);
 	// Sanity check first, if the passed action has no type or weapon, return 0.
 	if (!action->type || !action->weapon)
 	{
@@ -5335,6 +5399,7 @@ void AIModule::brutalBlaster()
  */
 void AIModule::brutalGrenadeAction()
 {
+	AITraceScope traceScope(_trace, AIT_GRENADE);
 	// do we have a grenade on our belt?
 	BattleItem *grenade = _unit->getGrenadeFromBelt();
 	BattleAction action;
@@ -5379,6 +5444,8 @@ void AIModule::brutalGrenadeAction()
 						action.target = currentPosition;
 						if (!validateArcingShot(&action))
 							continue;
+						if (_trace)
+							_trace->addCandidates(AIT_GRENADE, 1);
 						float currentEfficacy = brutalExplosiveEfficacy(currentPosition, _unit, radius, true, true);
 						if (currentEfficacy > bestScore)
 						{
@@ -6148,8 +6215,66 @@ int AIModule::getEnergyRecovery(BattleUnit* unit)
 	return recovery;
 }
 
+/**
+ * Starts the time budget of a brutal AI decision, if one is set.
+ * Battles that are recorded or replayed have no budget, as it would
+ * make the decisions depend on how fast the computer is.
+ */
+void AIModule::startThinkBudget()
+{
+	_thinkDeadline = 0;
+	_outOfTime = false;
+	if (Options::oxceBrutalAIBudget > 0 && !_save->getBattleGame()->getReplay())
+	{
+		_thinkDeadline = Profiler::now() + (Uint64)Options::oxceBrutalAIBudget * 1000;
+		++brutalBudgetStats.decisions;
+	}
+}
+
+/**
+ * Checks whether the current decision has used up its time budget,
+ * in which case the unit settles for the best answer found so far.
+ * @return True if there is no time left.
+ */
+bool AIModule::outOfTime()
+{
+	if (_thinkDeadline == 0 || Profiler::now() < _thinkDeadline)
+	{
+		return false;
+	}
+	if (!_outOfTime)
+	{
+		_outOfTime = true;
+		++brutalBudgetStats.hits;
+		if (_trace)
+			_trace->setOutOfTime();
+		if (_traceAI)
+		{
+			Log(LOG_INFO) << "#" << _unit->getId() << " ran out of its " << Options::oxceBrutalAIBudget << " ms budget.";
+		}
+	}
+	return true;
+}
+
+/**
+ * Writes how often brutal AI decisions ran out of time to the log,
+ * and resets the counters.
+ * @param reason Why the counters are written.
+ */
+void AIModule::dumpBudgetStats(const std::string &reason)
+{
+	if (brutalBudgetStats.decisions > 0)
+	{
+		Log(LOG_INFO) << "Brutal AI budget (" << reason << "): " << brutalBudgetStats.hits << " of " << brutalBudgetStats.decisions
+			<< " decisions ran out of time, " << brutalBudgetStats.tilesSkipped << " of "
+			<< brutalBudgetStats.tilesEvaluated + brutalBudgetStats.tilesSkipped << " tiles skipped.";
+	}
+	brutalBudgetStats = BrutalBudgetStats();
+}
+
 std::map<Position, int, PositionComparator> AIModule::getReachableBy(BattleUnit* unit, bool& ranOutOfTUs, bool forceRecalc, bool useMaxTUs)
 {
+	AITraceScope traceScope(_trace, AIT_REACHABILITY);
 	Position startPosition = _save->getTileCoords(unit->getTileLastSpotted(_unit->getFaction()));
 	if (_unit->isCheatOnMovement() || unit->getFaction() == _unit->getFaction())
 		startPosition = unit->getPosition();
@@ -6158,11 +6283,29 @@ std::map<Position, int, PositionComparator> AIModule::getReachableBy(BattleUnit*
 		ranOutOfTUs = unit->getRanOutOfTUs();
 		return unit->getReachablePositions();
 	}
-	std::vector<PathfindingNode*> reachable = _save->getPathfinding()->findReachablePathFindingNodes(unit, BattleActionCost(), ranOutOfTUs, false, NULL, &startPosition, false, useMaxTUs);
 	std::map<Position, int, PositionComparator> tuAtPositionMap;
 	int TUs = unit->getTimeUnits();
 	if (useMaxTUs)
 		TUs = getMaxTU(unit);
+	const AIPlanner::Reachable* planned = NULL;
+	if (useMaxTUs && _save->getBattleGame()->getAIPlanner())
+		planned = _save->getBattleGame()->getAIPlanner()->getReachable(unit, startPosition);
+	if (planned)
+	{
+		// flooded during the player's turn, and nothing it depends on changed since
+		_save->getPathfinding()->setUnit(unit);
+		if (planned->ranOutOfTUs)
+			ranOutOfTUs = true;
+		for (auto& cost : planned->costs)
+			tuAtPositionMap[cost.first] = TUs - cost.second;
+		unit->setPositionOfUpdate(startPosition);
+		unit->setReachablePositions(tuAtPositionMap);
+		unit->setRanOutOfTUs(ranOutOfTUs);
+		return tuAtPositionMap;
+	}
+	std::vector<PathfindingNode*> reachable = _save->getPathfinding()->findReachablePathFindingNodes(unit, BattleActionCost(), ranOutOfTUs, false, NULL, &startPosition, false, useMaxTUs);
+	if (_trace)
+		_trace->addCandidates(AIT_REACHABILITY, reachable.size());
 	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
 	{
 		tuAtPositionMap[(*it)->getPosition()] = TUs - (*it)->getTUCost(false).time;
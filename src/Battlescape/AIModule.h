@@ -33,6 +33,7 @@ class BattleUnit;
 struct BattleAction;
 class BattlescapeState;
 class Node;
+class AIDecisionTrace;
 
 enum AIMode { AI_PATROL, AI_AMBUSH, AI_COMBAT, AI_ESCAPE };
 /**
@@ -64,6 +65,9 @@ private:
 	BattleActionType _reserve;
 	UnitFaction _targetFaction;
 	UnitFaction _myFaction;
+	Uint64 _thinkDeadline;
+	bool _outOfTime;
+	AIDecisionTrace *_trace;
 
 	BattleAction _escapeAction, _ambushAction, _attackAction, _patrolAction, _psiAction;
 
@@ -71,6 +75,10 @@ private:
 	int selectNearestTargetLeeroy(bool canRun);
 	void meleeActionLeeroy(bool canRun);
 	void dont_think(BattleAction *action);
+	/// Starts the time budget of a brutal AI decision.
+	void startThinkBudget();
+	/// Has the current decision used up its time budget?
+	bool outOfTime();
 public:
 	/// Creates a new AIModule linked to the game and a certain unit.
 	AIModule(SavedBattleGame *save, BattleUnit *unit, Node *node);
@@ -84,6 +92,8 @@ public:
 	YAML::Node save() const;
 	/// Runs Module functionality every AI cycle.
 	void think(BattleAction *action);
+	/// Writes how often brutal AI decisions ran out of time to the log, and resets the counters.
+	static void dumpBudgetStats(const std::string &reason);
 	/// Sets the "unit was hit" flag true.
 	void setWasHitBy(BattleUnit *attacker);
 	/// Sets the "unit picked up a weapon" flag.
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include "AIPlanner.h"
+#include "BattlescapeGame.h"
+#include "Pathfinding.h"
+#include "PathfindingNode.h"
+#include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Tile.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Time in microseconds to wait before checking again after everything was planned.
+const Uint64 PLANNER_CHECK_INTERVAL = 250000;
+
+/**
+ * Combines a value into a hash.
+ */
+Uint64 mix(Uint64 hash, Uint64 value)
+{
+	return hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+}
+
+/**
+ * Combines a position into a hash.
+ */
+Uint64 mix(Uint64 hash, Position pos)
+{
+	return mix(mix(mix(hash, (Uint64)pos.x), (Uint64)pos.y), (Uint64)pos.z);
+}
+
+}
+
+/**
+ * Creates a planner for a battle.
+ * The planner has its own pathfinding, so planning does not disturb
+ * the paths the player is previewing.
+ * @param save Pointer to the battle.
+ */
+AIPlanner::AIPlanner(SavedBattleGame *save) : _save(save), _pathfinding(new Pathfinding(save)), _nextCheck(0), _decisionWorld(), _decisionWorldKnown()
+{
+}
+
+/**
+ * Cleans up the planner.
+ */
+AIPlanner::~AIPlanner()
+{
+	delete _pathfinding;
+}
+
+/**
+ * Gets a signature of everything on the map and the units that
+ * the pathfinding of a unit depends on.
+ * @param fire Does the pathfinding care about fire?
+ * @param smoke Does the pathfinding care about smoke?
+ * @return The signature.
+ */
+Uint64 AIPlanner::getWorldSignature(bool fire, bool smoke) const
+{
+	Uint64 hash = mix(0, (Uint64)Options::aiPerformanceOptimization);
+	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
+	{
+		Tile *tile = _save->getTile(i);
+		for (int part = O_FLOOR; part < O_MAX; ++part)
+		{
+			TilePart tp = (TilePart)part;
+			hash = mix(hash, (Uint64)(uintptr_t)tile->getMapData(tp));
+			hash = mix(hash, (Uint64)tile->isUfoDoorOpen(tp));
+		}
+		if (fire)
+		{
+			hash = mix(hash, (Uint64)tile->getFire());
+		}
+		if (smoke)
+		{
+			hash = mix(hash, (Uint64)tile->getSmoke());
+		}
+	}
+	for (BattleUnit *bu : *_save->getUnits())
+	{
+		hash = mix(hash, (Uint64)bu->getId());
+		hash = mix(hash, bu->getPosition());
+		hash = mix(hash, (Uint64)bu->isOut());
+		hash = mix(hash, (Uint64)bu->getFaction());
+		hash = mix(hash, (Uint64)bu->getVisible());
+		hash = mix(hash, (Uint64)(uintptr_t)bu->getArmor());
+	}
+	return hash;
+}
+
+/**
+ * Gets the signature of a flood for a unit.
+ * @param unit The unit to flood for.
+ * @param start Where the flood starts.
+ * @param world The signature of the map and units.
+ * @return The signature.
+ */
+Uint64 AIPlanner::getSignature(BattleUnit *unit, Position start, Uint64 world) const
+{
+	Uint64 hash = mix(world, (Uint64)unit->getId());
+	hash = mix(hash, start);
+	hash = mix(hash, (Uint64)unit->getBaseStats()->tu);
+	hash = mix(hash, (Uint64)unit->getBaseStats()->stamina);
+	if (unit->getFaction() == FACTION_HOSTILE)
+	{
+		// hostile units path around the units they spotted
+		for (BattleUnit *spotted : unit->getUnitsSpottedThisTurn())
+		{
+			hash = mix(hash, (Uint64)spotted->getId());
+		}
+	}
+	return hash;
+}
+
+/**
+ * Does the pathfinding of a unit care about fire?
+ * @param unit The unit.
+ * @return True if fire changes the paths of the unit.
+ */
+bool AIPlanner::caresAboutFire(BattleUnit *unit) const
+{
+	return _save->getDepth() > 0 || (unit->getFaction() != FACTION_PLAYER && unit->avoidsFire());
+}
+
+/**
+ * Floods the tiles a unit can reach with full TUs, unless the
+ * flood that was planned before still matches the battle.
+ * @param unit The unit.
+ * @param start Where the flood starts.
+ * @param world The signature of the map and units.
+ * @return True if the flood had to be done.
+ */
+bool AIPlanner::plan(BattleUnit *unit, Position start, Uint64 world)
+{
+	Uint64 signature = getSignature(unit, start, world);
+	Reachable &reachable = _reachable[std::make_pair(unit->getId(), _save->getTileIndex(start))];
+	if (!reachable.costs.empty() && reachable.signature == signature)
+	{
+		return false;
+	}
+	bool ranOutOfTUs = false;
+	std::vector<PathfindingNode*> nodes = _pathfinding->findReachablePathFindingNodes(unit, BattleActionCost(), ranOutOfTUs, false, NULL, &start, false, true);
+	reachable.start = start;
+	reachable.signature = signature;
+	reachable.ranOutOfTUs = ranOutOfTUs;
+	reachable.costs.clear();
+	reachable.costs.reserve(nodes.size());
+	for (PathfindingNode *node : nodes)
+	{
+		reachable.costs.push_back(std::make_pair(node->getPosition(), (int)node->getTUCost(false).time));
+	}
+	return true;
+}
+
+/**
+ * Plans the floods the brutal AI will need at the start of its turn,
+ * until the time runs out or everything is up to date.
+ * @param end Time to stop planning, see Profiler::now().
+ */
+void AIPlanner::think(Uint64 end)
+{
+	// the player's turn goes on, so the decision is over
+	startDecision();
+	if (Profiler::now() < _nextCheck)
+	{
+		return;
+	}
+	bool brutal = false, cheat = false;
+	for (BattleUnit *bu : *_save->getUnits())
+	{
+		if (!bu->isOut() && bu->getFaction() == FACTION_HOSTILE)
+		{
+			brutal = brutal || bu->isBrutal();
+			cheat = cheat || bu->isCheatOnMovement();
+		}
+	}
+	if (!brutal)
+	{
+		_reachable.clear();
+		_nextCheck = Profiler::now() + PLANNER_CHECK_INTERVAL;
+		return;
+	}
+
+	// the starts the AI will look at: where it last saw its enemies, or where they are if it cheats
+	std::vector<std::pair<BattleUnit*, Position> > starts;
+	for (BattleUnit *bu : *_save->getUnits())
+	{
+		if (bu->isOut() || bu->getFaction() == FACTION_HOSTILE)
+		{
+			continue;
+		}
+		int spotted = bu->getTileLastSpotted(FACTION_HOSTILE);
+		if (spotted != -1)
+		{
+			starts.push_back(std::make_pair(bu, _save->getTileCoords(spotted)));
+		}
+		if (cheat && (spotted == -1 || _save->getTileCoords(spotted) != bu->getPosition()))
+		{
+			starts.push_back(std::make_pair(bu, bu->getPosition()));
+		}
+	}
+
+	// forget floods nobody will ask for
+	for (auto i = _reachable.begin(); i != _reachable.end();)
+	{
+		auto wanted = std::find_if(starts.begin(), starts.end(), [&](const std::pair<BattleUnit*, Position> &start)
+			{
+				return start.first->getId() == i->first.first && _save->getTileIndex(start.second) == i->first.second;
+			});
+		if (wanted == starts.end())
+		{
+			i = _reachable.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	const bool smoke = _save->getDepth() > 0;
+	Uint64 world[2] = { };
+	bool known[2] = { };
+	for (auto &start : starts)
+	{
+		int fire = caresAboutFire(start.first) ? 1 : 0;
+		if (!known[fire])
+		{
+			world[fire] = getWorldSignature(fire, smoke);
+			known[fire] = true;
+		}
+		if (plan(start.first, start.second, world[fire]) && Profiler::now() >= end)
+		{
+			return;
+		}
+	}
+	_nextCheck = Profiler::now() + PLANNER_CHECK_INTERVAL;
+}
+
+/**
+ * Starts an AI decision. Nothing on the map or the units changes
+ * while the AI is thinking, so the signature of the battle is only
+ * worked out on the first lookup of the decision.
+ */
+void AIPlanner::startDecision()
+{
+	_decisionWorldKnown[0] = false;
+	_decisionWorldKnown[1] = false;
+}
+
+/**
+ * Gets the planned flood of a unit with full TUs.
+ * Must be called during an AI decision, see startDecision().
+ * @param unit The unit.
+ * @param start Where the flood starts.
+ * @return The flood, or nullptr if it was not planned or the battle changed since.
+ */
+const AIPlanner::Reachable *AIPlanner::getReachable(BattleUnit *unit, Position start)
+{
+	auto i = _reachable.find(std::make_pair(unit->getId(), _save->getTileIndex(start)));
+	if (i == _reachable.end() || i->second.costs.empty() || i->second.start != start)
+	{
+		return nullptr;
+	}
+	int fire = caresAboutFire(unit) ? 1 : 0;
+	if (!_decisionWorldKnown[fire])
+	{
+		_decisionWorld[fire] = getWorldSignature(fire, _save->getDepth() > 0);
+		_decisionWorldKnown[fire] = true;
+	}
+	if (i->second.signature != getSignature(unit, start, _decisionWorld[fire]))
+	{
+		return nullptr;
+	}
+	return &i->second;
+}
+
+}
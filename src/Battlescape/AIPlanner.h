@@ -0,0 +1,89 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <map>
+#include <utility>
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class BattleUnit;
+class Pathfinding;
+class SavedBattleGame;
+
+/**
+ * Plans ahead for the alien turn while the player's turn is idle.
+ * Floods the area the enemies of the aliens can reach from where they
+ * were last spotted, which the brutal AI needs at the start of its turn.
+ * Each result is stored with a signature of everything the flood depends on,
+ * and is only handed out while the battle still matches that signature.
+ * The signature of the battle is worked out once per AI decision.
+ */
+class AIPlanner
+{
+public:
+	/// Time in microseconds the planner may spend in one frame.
+	static const Uint64 FRAME_BUDGET = 4000;
+
+	/// Tiles a unit can reach with full TUs, and the TU cost to reach them.
+	struct Reachable
+	{
+		Position start;
+		Uint64 signature = 0;
+		bool ranOutOfTUs = false;
+		std::vector<std::pair<Position, int> > costs;
+	};
+
+private:
+	SavedBattleGame *_save;
+	Pathfinding *_pathfinding;
+	std::map<std::pair<int, int>, Reachable> _reachable;
+	Uint64 _nextCheck;
+	Uint64 _decisionWorld[2];
+	bool _decisionWorldKnown[2];
+
+	/// Gets a signature of the map and units, as seen by pathfinding.
+	Uint64 getWorldSignature(bool fire, bool smoke) const;
+	/// Gets the signature of a flood for a unit.
+	Uint64 getSignature(BattleUnit *unit, Position start, Uint64 world) const;
+	/// Does the pathfinding of a unit care about fire?
+	bool caresAboutFire(BattleUnit *unit) const;
+	/// Plans the flood of a unit, if it is out of date.
+	bool plan(BattleUnit *unit, Position start, Uint64 world);
+public:
+	/// Creates a planner for a battle.
+	AIPlanner(SavedBattleGame *save);
+	/// Cleans up the planner.
+	~AIPlanner();
+
+	AIPlanner(const AIPlanner&) = delete;
+	AIPlanner& operator=(const AIPlanner&) = delete;
+
+	/// Plans ahead until the time runs out or nothing is left to plan.
+	void think(Uint64 end);
+	/// Starts an AI decision, during which the battle does not change.
+	void startDecision();
+	/// Gets the planned flood of a unit, if it still matches the battle.
+	const Reachable *getReachable(BattleUnit *unit, Position start);
+};
+
+}
@@ -214,6 +214,7 @@ void AbortMissionState::btnOkClick(Action *)
 		return;
 	}
 
+	_state->getBattleGame()->stopRecording("aborting the mission");
 	_game->popState();
 	_battleGame->setAborted(true);
 	_state->finishBattle(true, _inExit);
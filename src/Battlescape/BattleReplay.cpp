@@ -0,0 +1,652 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iomanip>
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+#include "BattleReplay.h"
+#include "BattlescapeGame.h"
+#include "BattlescapeState.h"
+#include "Pathfinding.h"
+#include "TileEngine.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Game.h"
+#include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/RNG.h"
+#include "../Mod/Mod.h"
+#include "../Mod/RuleSkill.h"
+#include "../Savegame/BattleItem.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/SavedGame.h"
+#include "../md5.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Number of battle steps without progress after which a replay runs the next command anyway.
+const int REPLAY_STALL_LIMIT = 1000;
+
+/// Name of the replay the next battle should play.
+std::string nextReplay;
+/// Is a replay being measured?
+bool replayMeasuring = false;
+/// Time spent in each part of the battle, in microseconds.
+Uint64 replayCosts[REPLAY_COSTS];
+
+/**
+ * Finds a unit by its ID.
+ */
+BattleUnit *findUnit(SavedBattleGame *save, int id)
+{
+	if (id >= 0)
+	{
+		for (auto* bu : *save->getUnits())
+		{
+			if (bu->getId() == id)
+			{
+				return bu;
+			}
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Finds an item by its ID.
+ */
+BattleItem *findItem(SavedBattleGame *save, int id)
+{
+	if (id >= 0)
+	{
+		for (auto* bi : *save->getItems())
+		{
+			if (bi->getId() == id)
+			{
+				return bi;
+			}
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Loads a command from YAML.
+ */
+BattleReplay::Command loadCommand(const YAML::Node &node)
+{
+	BattleReplay::Command cmd;
+	cmd.command = (BattleReplayCommand)node["cmd"].as<int>(cmd.command);
+	cmd.step = node["step"].as<Uint64>(cmd.step);
+	cmd.pos = node["pos"].as<Position>(cmd.pos);
+	cmd.arg = node["arg"].as<int>(cmd.arg);
+	cmd.selected = node["selected"].as<int>(cmd.selected);
+	cmd.actor = node["actor"].as<int>(cmd.actor);
+	cmd.weapon = node["weapon"].as<int>(cmd.weapon);
+	cmd.type = (BattleActionType)node["type"].as<int>(cmd.type);
+	cmd.targeting = node["targeting"].as<bool>(cmd.targeting);
+	cmd.sprayTargeting = node["spray"].as<bool>(cmd.sprayTargeting);
+	cmd.value = node["value"].as<int>(cmd.value);
+	cmd.terrainMeleeTilePart = node["terrainMelee"].as<int>(cmd.terrainMeleeTilePart);
+	cmd.skill = node["skill"].as<std::string>(cmd.skill);
+	cmd.waypoints = node["waypoints"].as<std::vector<Position> >(cmd.waypoints);
+	if (const YAML::Node &cost = node["cost"])
+	{
+		cmd.cost.Time = cost[0].as<int>(0);
+		cmd.cost.Energy = cost[1].as<int>(0);
+		cmd.cost.Morale = cost[2].as<int>(0);
+		cmd.cost.Health = cost[3].as<int>(0);
+		cmd.cost.Stun = cost[4].as<int>(0);
+		cmd.cost.Mana = cost[5].as<int>(0);
+	}
+	int keys = node["keys"].as<int>(0);
+	cmd.ctrl = (keys & 1) != 0;
+	cmd.alt = (keys & 2) != 0;
+	cmd.shift = (keys & 4) != 0;
+	return cmd;
+}
+
+/**
+ * Saves a command to YAML, leaving out default values.
+ */
+YAML::Node saveCommand(const BattleReplay::Command &cmd)
+{
+	YAML::Node node;
+	node.SetStyle(YAML::EmitterStyle::Flow);
+	node["cmd"] = (int)cmd.command;
+	node["step"] = cmd.step;
+	if (cmd.pos != Position(-1, -1, -1))
+		node["pos"] = cmd.pos;
+	if (cmd.arg)
+		node["arg"] = cmd.arg;
+	if (cmd.selected != -1)
+		node["selected"] = cmd.selected;
+	if (cmd.actor != -1)
+		node["actor"] = cmd.actor;
+	if (cmd.weapon != -1)
+		node["weapon"] = cmd.weapon;
+	if (cmd.type != BA_NONE)
+		node["type"] = (int)cmd.type;
+	if (cmd.targeting)
+		node["targeting"] = cmd.targeting;
+	if (cmd.sprayTargeting)
+		node["spray"] = cmd.sprayTargeting;
+	if (cmd.value)
+		node["value"] = cmd.value;
+	if (cmd.terrainMeleeTilePart)
+		node["terrainMelee"] = cmd.terrainMeleeTilePart;
+	if (!cmd.skill.empty())
+		node["skill"] = cmd.skill;
+	if (!cmd.waypoints.empty())
+		node["waypoints"] = cmd.waypoints;
+	if (cmd.cost.Time || cmd.cost.Energy || cmd.cost.Morale || cmd.cost.Health || cmd.cost.Stun || cmd.cost.Mana)
+	{
+		YAML::Node cost;
+		cost.SetStyle(YAML::EmitterStyle::Flow);
+		cost.push_back(cmd.cost.Time);
+		cost.push_back(cmd.cost.Energy);
+		cost.push_back(cmd.cost.Morale);
+		cost.push_back(cmd.cost.Health);
+		cost.push_back(cmd.cost.Stun);
+		cost.push_back(cmd.cost.Mana);
+		node["cost"] = cost;
+	}
+	int keys = (cmd.ctrl ? 1 : 0) | (cmd.alt ? 2 : 0) | (cmd.shift ? 4 : 0);
+	if (keys)
+		node["keys"] = keys;
+	return node;
+}
+
+/**
+ * Formats a time in microseconds as milliseconds.
+ */
+std::string formatTime(Uint64 us)
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1) << us / 1000.0 << " ms";
+	return ss.str();
+}
+
+}
+
+/**
+ * Creates a replay.
+ * @param name Name of the replay files, without extension.
+ * @param playing True to play an existing replay, false to record a new one.
+ */
+BattleReplay::BattleReplay(const std::string &name, bool playing) : _name(name), _playing(playing), _started(false), _finished(false),
+	_seed(0), _step(0), _steps(0), _startTime(0), _next(0), _stall(0), _lastStep(0),
+	_previewPath(Options::battleNewPreviewPath), _confirmFire(Options::battleConfirmFireMode), _strafe(Options::strafe), _watchSelected(-1)
+{
+}
+
+/**
+ * Cleans up the replay, a recording is lost if the battle did not end.
+ */
+BattleReplay::~BattleReplay()
+{
+	if (isPlaying())
+	{
+		Log(LOG_WARNING) << "Replay " << _name << " was interrupted at step " << _step << ".";
+		replayMeasuring = false;
+		Options::battleNewPreviewPath = _previewPath;
+		Options::battleConfirmFireMode = _confirmFire;
+		Options::strafe = _strafe;
+	}
+}
+
+/**
+ * Sets the replay the next battle will play.
+ * @param name Name of the replay files, without extension.
+ */
+void BattleReplay::setNext(const std::string &name)
+{
+	nextReplay = name;
+}
+
+/**
+ * Takes the replay the next battle should play.
+ * @return Name of the replay, or an empty string.
+ */
+std::string BattleReplay::takeNext()
+{
+	std::string name;
+	std::swap(name, nextReplay);
+	return name;
+}
+
+/**
+ * Gets a name for a new replay that does not overwrite older ones.
+ * @return Name of the replay files, without extension.
+ */
+std::string BattleReplay::getNewName()
+{
+	std::ostringstream ss;
+	int i = 0;
+	do
+	{
+		ss.str("");
+		ss << "replay" << std::setfill('0') << std::setw(3) << i;
+		i++;
+	}
+	while (CrossPlatform::fileExists(Options::getMasterUserFolder() + ss.str() + ".replay") || CrossPlatform::fileExists(Options::getMasterUserFolder() + ss.str() + ".rsav"));
+	return ss.str();
+}
+
+/**
+ * Starts the replay, once the battle is ready for player input.
+ * A recording saves the game, a playback loads the commands
+ * and puts the random generator and options in the recorded state.
+ * @param battle Pointer to the battle game.
+ */
+void BattleReplay::start(BattlescapeGame *battle)
+{
+	_started = true;
+	_step = 0;
+	_next = 0;
+	Game *game = battle->getSave()->getBattleState()->getGame();
+	if (_playing)
+	{
+		std::string filename = Options::getMasterUserFolder() + _name + ".replay";
+		try
+		{
+			YAML::Node doc = YAML::Load(*CrossPlatform::readFile(filename));
+			_seed = doc["seed"].as<uint64_t>();
+			_steps = doc["steps"].as<Uint64>(0);
+			_hash = doc["hash"].as<std::string>("");
+			_previewPath = (PathPreview)doc["battleNewPreviewPath"].as<int>(_previewPath);
+			_confirmFire = doc["battleConfirmFireMode"].as<bool>(_confirmFire);
+			_strafe = doc["strafe"].as<bool>(_strafe);
+			for (const auto& command : doc["commands"])
+			{
+				_commands.push_back(loadCommand(command));
+			}
+		}
+		catch (std::exception &e)
+		{
+			Log(LOG_ERROR) << "Failed to load replay " << filename << ": " << e.what();
+			_finished = true;
+			return;
+		}
+		std::swap(_previewPath, Options::battleNewPreviewPath);
+		std::swap(_confirmFire, Options::battleConfirmFireMode);
+		std::swap(_strafe, Options::strafe);
+		RNG::setSeed(_seed);
+
+		for (auto& cost : replayCosts)
+		{
+			cost = 0;
+		}
+		replayMeasuring = true;
+		_startTime = Profiler::now();
+		Log(LOG_INFO) << "Replaying " << _name << ", " << _commands.size() << " commands.";
+	}
+	else
+	{
+		_seed = RNG::getSeed();
+		game->getSavedGame()->save(_name + ".rsav", game->getMod());
+		Log(LOG_INFO) << "Recording battle to " << _name << ".";
+	}
+}
+
+/**
+ * Records a player command with the current action.
+ * @param battle Pointer to the battle game.
+ * @param command Command to record.
+ * @param pos Position on the map, if the command needs one.
+ * @param arg Extra argument of the command.
+ */
+void BattleReplay::record(BattlescapeGame *battle, BattleReplayCommand command, Position pos, int arg)
+{
+	SavedBattleGame *save = battle->getSave();
+	const BattleAction *action = battle->getCurrentAction();
+	Command cmd;
+	cmd.command = command;
+	cmd.step = _step;
+	cmd.pos = pos;
+	cmd.arg = arg;
+	cmd.selected = save->getSelectedUnit() ? save->getSelectedUnit()->getId() : -1;
+	cmd.actor = action->actor ? action->actor->getId() : -1;
+	cmd.weapon = action->weapon ? action->weapon->getId() : -1;
+	cmd.type = action->type;
+	cmd.targeting = action->targeting;
+	cmd.sprayTargeting = action->sprayTargeting;
+	cmd.value = action->value;
+	cmd.terrainMeleeTilePart = action->terrainMeleeTilePart;
+	cmd.skill = action->skillRules ? action->skillRules->getType() : "";
+	cmd.waypoints.assign(action->waypoints.begin(), action->waypoints.end());
+	cmd.cost = *action;
+	cmd.ctrl = save->isCtrlPressed(true);
+	cmd.alt = save->isAltPressed(true);
+	cmd.shift = save->isShiftPressed(true);
+	_commands.push_back(cmd);
+}
+
+/**
+ * Stops recording, the battle can no longer be replayed.
+ * The replay file is not written when the battle ends.
+ * @param input Input that cannot be recorded.
+ */
+void BattleReplay::stopRecording(const std::string &input)
+{
+	if (!isRecording())
+	{
+		return;
+	}
+	_finished = true;
+	Log(LOG_WARNING) << "Replay " << _name << " stopped recording at step " << _step << ": " << input << " cannot be recorded.";
+}
+
+/**
+ * Remembers the battle state before a screen whose inputs are not recorded,
+ * like the inventory or the action menu with the medikit and scanner in it.
+ * @param save Pointer to the battle save.
+ * @param screen Name of the screen, for the log.
+ */
+void BattleReplay::watch(SavedBattleGame *save, const std::string &screen)
+{
+	if (!isRecording())
+	{
+		return;
+	}
+	_watchScreen = screen;
+	_watchHash = getStateHash(save);
+	_watchSelected = save->getSelectedUnit() ? save->getSelectedUnit()->getId() : -1;
+}
+
+/**
+ * Stops recording if the battle changed while the watched screen was open.
+ * Selecting another unit does not count, every command restores its selected unit.
+ * @param save Pointer to the battle save.
+ */
+void BattleReplay::checkWatched(SavedBattleGame *save)
+{
+	if (_watchScreen.empty())
+	{
+		return;
+	}
+	std::string screen;
+	std::swap(screen, _watchScreen);
+	if (!isRecording())
+	{
+		return;
+	}
+	BattleUnit *selected = save->getSelectedUnit();
+	save->setSelectedUnit(findUnit(save, _watchSelected));
+	std::string hash = getStateHash(save);
+	save->setSelectedUnit(selected);
+	if (hash != _watchHash)
+	{
+		stopRecording("changes made in the " + screen);
+	}
+}
+
+/**
+ * Runs all commands that are due at the current step.
+ * If the battle does not advance while a command is waiting,
+ * the replay went out of sync and the command is run anyway.
+ * @param battle Pointer to the battle game.
+ */
+void BattleReplay::play(BattlescapeGame *battle)
+{
+	if (!isPlaying())
+	{
+		return;
+	}
+	if (_step != _lastStep)
+	{
+		_lastStep = _step;
+		_stall = 0;
+	}
+	else if (_next < _commands.size() && _commands[_next].step > _step && ++_stall > REPLAY_STALL_LIMIT)
+	{
+		Log(LOG_WARNING) << "Replay " << _name << " is out of sync at step " << _step << ", expected step " << _commands[_next].step << ".";
+		_commands[_next].step = _step;
+	}
+	while (_next < _commands.size() && _commands[_next].step <= _step)
+	{
+		execute(battle, _commands[_next++]);
+	}
+	if (_next == _commands.size() && _step >= _steps && !battle->isBusy())
+	{
+		finish(battle->getSave());
+	}
+}
+
+/**
+ * Puts the recorded action back and runs the command
+ * the same way the battlescape buttons do.
+ * @param battle Pointer to the battle game.
+ * @param cmd Command to run.
+ */
+void BattleReplay::execute(BattlescapeGame *battle, const Command &cmd)
+{
+	SavedBattleGame *save = battle->getSave();
+	Game *game = save->getBattleState()->getGame();
+	save->setSelectedUnit(findUnit(save, cmd.selected));
+	BattleAction *action = battle->getCurrentAction();
+	action->actor = findUnit(save, cmd.actor);
+	action->weapon = findItem(save, cmd.weapon);
+	action->type = cmd.type;
+	action->targeting = cmd.targeting;
+	action->sprayTargeting = cmd.sprayTargeting;
+	action->value = cmd.value;
+	action->terrainMeleeTilePart = cmd.terrainMeleeTilePart;
+	action->skillRules = cmd.skill.empty() ? nullptr : battle->getMod()->getSkill(cmd.skill);
+	action->waypoints.assign(cmd.waypoints.begin(), cmd.waypoints.end());
+	*(RuleItemUseCost*)action = cmd.cost;
+
+	bool ctrl = game->getCtrlPressedFlag(), alt = game->getAltPressedFlag(), shift = game->getShiftPressedFlag();
+	game->setCtrlPressedFlag(cmd.ctrl);
+	game->setAltPressedFlag(cmd.alt);
+	game->setShiftPressedFlag(cmd.shift);
+
+	BattleUnit *unit = save->getSelectedUnit();
+	switch (cmd.command)
+	{
+	case BRC_PRIMARY:
+		battle->primaryAction(cmd.pos);
+		break;
+	case BRC_SECONDARY:
+		battle->secondaryAction(cmd.pos);
+		break;
+	case BRC_NON_TARGET:
+		battle->handleNonTargetAction();
+		break;
+	case BRC_CANCEL:
+		battle->cancelCurrentAction();
+		break;
+	case BRC_LAUNCH:
+		battle->launchAction();
+		break;
+	case BRC_PSI:
+		battle->psiButtonAction();
+		break;
+	case BRC_UP:
+	case BRC_DOWN:
+		if (unit)
+		{
+			battle->cancelAllActions();
+			battle->moveUpDown(unit, cmd.command == BRC_UP ? Pathfinding::DIR_UP : Pathfinding::DIR_DOWN);
+		}
+		break;
+	case BRC_KNEEL:
+		if (unit)
+		{
+			battle->kneel(unit);
+		}
+		break;
+	case BRC_RELOAD:
+		if (unit)
+		{
+			unit->reloadAmmo();
+		}
+		break;
+	case BRC_ZERO_TU:
+		if (unit)
+		{
+			unit->clearTimeUnits();
+		}
+		break;
+	case BRC_LIGHT:
+		save->getTileEngine()->togglePersonalLighting();
+		break;
+	case BRC_RESERVE:
+		battle->setTUReserved((BattleActionType)cmd.arg);
+		break;
+	case BRC_RESERVE_KNEEL:
+		battle->setKneelReserved(cmd.arg != 0);
+		break;
+	case BRC_END_TURN:
+		battle->requestEndTurn(false);
+		break;
+	}
+
+	game->setCtrlPressedFlag(ctrl);
+	game->setAltPressedFlag(alt);
+	game->setShiftPressedFlag(shift);
+	save->getBattleState()->updateSoldierInfo();
+}
+
+/**
+ * Finishes the replay. A recording is saved with the hash of the
+ * final state, a playback reports its costs and checks the hash.
+ * @param save Pointer to the battle save.
+ */
+void BattleReplay::finish(SavedBattleGame *save)
+{
+	if (!_started || _finished)
+	{
+		return;
+	}
+	_finished = true;
+	std::string hash = getStateHash(save);
+	if (_playing)
+	{
+		replayMeasuring = false;
+		Options::battleNewPreviewPath = _previewPath;
+		Options::battleConfirmFireMode = _confirmFire;
+		Options::strafe = _strafe;
+
+		Log(LOG_INFO) << "Replay " << _name << " finished at step " << _step << " of " << _steps << " in " << formatTime(Profiler::now() - _startTime) << ".";
+		Log(LOG_INFO) << "Simulation: " << formatTime(replayCosts[REPLAY_SIMULATION])
+			<< ", pathfinding: " << formatTime(replayCosts[REPLAY_PATHFINDING])
+			<< ", FOV: " << formatTime(replayCosts[REPLAY_FOV])
+			<< ", AI: " << formatTime(replayCosts[REPLAY_AI]) << ".";
+		if (hash == _hash)
+		{
+			Log(LOG_INFO) << "Final state " << hash << " matches the recording.";
+		}
+		else
+		{
+			Log(LOG_WARNING) << "Final state " << hash << " differs from the recording " << _hash << ".";
+		}
+	}
+	else
+	{
+		YAML::Emitter out;
+		YAML::Node doc;
+		doc["seed"] = _seed;
+		doc["steps"] = _step;
+		doc["hash"] = hash;
+		doc["battleNewPreviewPath"] = (int)_previewPath;
+		doc["battleConfirmFireMode"] = _confirmFire;
+		doc["strafe"] = _strafe;
+		for (const auto& cmd : _commands)
+		{
+			doc["commands"].push_back(saveCommand(cmd));
+		}
+		out << doc;
+		std::string filename = Options::getMasterUserFolder() + _name + ".replay";
+		if (CrossPlatform::writeFile(filename, out.c_str()))
+		{
+			Log(LOG_INFO) << "Recorded " << _commands.size() << " commands to " << filename << ".";
+		}
+		else
+		{
+			Log(LOG_ERROR) << "Failed to save replay " << filename;
+		}
+	}
+}
+
+/**
+ * Gets a hash of the battle state and the random generator,
+ * two battles that ended the same have the same hash.
+ * @param save Pointer to the battle save.
+ * @return Hex digest of the state.
+ */
+std::string BattleReplay::getStateHash(SavedBattleGame *save)
+{
+	YAML::Emitter out;
+	out << save->save();
+	std::ostringstream ss;
+	ss << RNG::getSeed();
+	MD5 md5;
+	md5.update(out.c_str(), static_cast<MD5::size_type>(out.size()));
+	md5.update(ss.str().c_str(), static_cast<MD5::size_type>(ss.str().size()));
+	md5.finalize();
+	return md5.hexdigest();
+}
+
+/**
+ * Is a replay being played back and measured?
+ * @return True while the costs are recorded.
+ */
+bool BattleReplay::isMeasuring()
+{
+	return replayMeasuring;
+}
+
+/**
+ * Adds time spent in a part of the battle.
+ * @param cost Part of the battle.
+ * @param duration Time in microseconds.
+ */
+void BattleReplay::addCost(BattleReplayCost cost, Uint64 duration)
+{
+	replayCosts[cost] += duration;
+}
+
+/**
+ * Starts measuring a part of the battle.
+ * @param cost Part of the battle.
+ */
+BattleReplayScope::BattleReplayScope(BattleReplayCost cost) : _cost(cost), _start(0), _measuring(BattleReplay::isMeasuring())
+{
+	if (_measuring)
+	{
+		_start = Profiler::now();
+	}
+}
+
+/**
+ * Adds the time spent since the start.
+ */
+BattleReplayScope::~BattleReplayScope()
+{
+	if (_measuring)
+	{
+		BattleReplay::addCost(_cost, Profiler::now() - _start);
+	}
+}
+
+}
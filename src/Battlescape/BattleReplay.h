@@ -0,0 +1,155 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+#include "Position.h"
+#include "../Mod/RuleItem.h"
+#include "../Engine/Options.h"
+
+namespace OpenXcom
+{
+
+class BattlescapeGame;
+class SavedBattleGame;
+
+/**
+ * Player commands that can be recorded and replayed.
+ */
+enum BattleReplayCommand : Uint8 { BRC_PRIMARY, BRC_SECONDARY, BRC_NON_TARGET, BRC_CANCEL, BRC_LAUNCH, BRC_PSI, BRC_UP, BRC_DOWN, BRC_KNEEL, BRC_RELOAD, BRC_ZERO_TU, BRC_LIGHT, BRC_RESERVE, BRC_RESERVE_KNEEL, BRC_END_TURN };
+
+/**
+ * Parts of the battle measured during a replay.
+ * Pathfinding, FOV and AI are nested in the simulation.
+ */
+enum BattleReplayCost { REPLAY_SIMULATION, REPLAY_PATHFINDING, REPLAY_FOV, REPLAY_AI, REPLAY_COSTS };
+
+/**
+ * Records the player commands of a battle, or plays them back.
+ * The battle state at the start of the recording is saved next to
+ * the commands, so the replay can run the same battle again without
+ * animations and check that it ends in the same state.
+ */
+class BattleReplay
+{
+public:
+	/// One recorded player command and the action it was given with.
+	struct Command
+	{
+		BattleReplayCommand command = BRC_PRIMARY;
+		Uint64 step = 0;
+		Position pos = Position(-1, -1, -1);
+		int arg = 0;
+		int selected = -1;
+		int actor = -1;
+		int weapon = -1;
+		BattleActionType type = BA_NONE;
+		bool targeting = false;
+		bool sprayTargeting = false;
+		int value = 0;
+		int terrainMeleeTilePart = 0;
+		std::string skill;
+		std::vector<Position> waypoints;
+		RuleItemUseCost cost;
+		bool ctrl = false, alt = false, shift = false;
+	};
+
+private:
+	std::string _name;
+	bool _playing, _started, _finished;
+	uint64_t _seed;
+	Uint64 _step, _steps, _startTime;
+	std::string _hash;
+	std::vector<Command> _commands;
+	size_t _next;
+	int _stall;
+	Uint64 _lastStep;
+	PathPreview _previewPath;
+	bool _confirmFire, _strafe;
+	std::string _watchScreen, _watchHash;
+	int _watchSelected;
+
+	/// Runs one command.
+	void execute(BattlescapeGame *battle, const Command &cmd);
+public:
+	/// Creates a recorder, or a player for an existing replay.
+	BattleReplay(const std::string &name, bool playing);
+	/// Cleans up the replay.
+	~BattleReplay();
+	/// Sets the replay the next battle will play.
+	static void setNext(const std::string &name);
+	/// Takes the replay the next battle should play.
+	static std::string takeNext();
+	/// Gets the name of a new replay.
+	static std::string getNewName();
+	/// Starts recording or playing.
+	void start(BattlescapeGame *battle);
+	/// Has the replay started?
+	bool isStarted() const { return _started; }
+	/// Is the replay played back?
+	bool isPlaying() const { return _playing && _started && !_finished; }
+	/// Is the battle recorded?
+	bool isRecording() const { return !_playing && _started && !_finished; }
+	/// Is the replay done?
+	bool isFinished() const { return _finished; }
+	/// Records a player command.
+	void record(BattlescapeGame *battle, BattleReplayCommand command, Position pos, int arg);
+	/// Stops recording after an input that cannot be recorded.
+	void stopRecording(const std::string &input);
+	/// Remembers the battle state before a screen that is not recorded.
+	void watch(SavedBattleGame *save, const std::string &screen);
+	/// Stops recording if the watched screen changed the battle.
+	void checkWatched(SavedBattleGame *save);
+	/// Advances the battle clock after a step of the battle game.
+	void step() { ++_step; }
+	/// Runs all commands that are due.
+	void play(BattlescapeGame *battle);
+	/// Finishes the replay, saving or checking the final state.
+	void finish(SavedBattleGame *save);
+	/// Gets a hash of the battle state.
+	static std::string getStateHash(SavedBattleGame *save);
+
+	/// Is a replay being measured?
+	static bool isMeasuring();
+	/// Adds time spent in a part of the battle.
+	static void addCost(BattleReplayCost cost, Uint64 duration);
+};
+
+/**
+ * Measures the time spent in a scope and adds it to the
+ * replay costs. Does nothing if no replay is played back.
+ */
+class BattleReplayScope
+{
+	BattleReplayCost _cost;
+	Uint64 _start;
+	bool _measuring;
+
+public:
+	/// Starts measuring.
+	BattleReplayScope(BattleReplayCost cost);
+	/// Ends measuring.
+	~BattleReplayScope();
+
+	BattleReplayScope(const BattleReplayScope&) = delete;
+	BattleReplayScope& operator=(const BattleReplayScope&) = delete;
+};
+
+}
@@ -59,6 +59,8 @@
 #include "../Savegame/BattleUnitStatistics.h"
 #include "ConfirmEndMissionState.h"
 #include "../fmath.h"
+#include "BattleReplay.h"
+#include "AIPlanner.h"
 
 namespace OpenXcom
 {
@@ -177,12 +179,28 @@ bool BattleActionCost::spendTU(std::string *message)
  */
 BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _nextUnitToSelect(NULL),
 	_playerPanicHandled(true), _AIActionCounter(0), _playedAggroSound(false),
-	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false)
+	_endTurnRequested(false), _endConfirmationHandled(false), _allEnemiesNeutralized(false), _replay(nullptr), _aiPlanner(nullptr)
 {
 	if (_save->isPreview())
 	{
 		_allEnemiesNeutralized = true; // just in case
 	}
+	else
+	{
+		std::string replay = BattleReplay::takeNext();
+		if (!replay.empty())
+		{
+			_replay = new BattleReplay(replay, true);
+		}
+		else if (Options::oxceBattleReplayRecord)
+		{
+			_replay = new BattleReplay(BattleReplay::getNewName(), false);
+		}
+		if (Options::oxceAIPlanAhead)
+		{
+			_aiPlanner = new AIPlanner(_save);
+		}
+	}
 
 	_currentAction.actor = 0;
 	_currentAction.targeting = false;
@@ -208,6 +226,8 @@ BattlescapeGame::~BattlescapeGame()
 		delete bs;
 	}
 	cleanupDeleted();
+	delete _replay;
+	delete _aiPlanner;
 }
 
 /**
@@ -215,6 +235,15 @@ BattlescapeGame::~BattlescapeGame()
  */
 void BattlescapeGame::think()
 {
+	if (_replay)
+	{
+		if (!_replay->isStarted())
+		{
+			_replay->start(this);
+		}
+		_replay->play(this);
+	}
+
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
 	{
@@ -222,6 +251,10 @@ void BattlescapeGame::think()
 		{
 			statePushFront(new UnitFallBState(this));
 			_save->setUnitsFalling(false);
+			if (_replay)
+			{
+				_replay->step();
+			}
 			return;
 		}
 		// it's a non player side (ALIENS or CIVILIANS)
@@ -263,6 +296,10 @@ void BattlescapeGame::think()
 				_save->getBattleState()->updateSoldierInfo();
 			}
 		}
+		if (_replay && !_states.empty())
+		{
+			_replay->step();
+		}
 	}
 }
 
@@ -284,6 +321,7 @@ void BattlescapeGame::init()
  */
 void BattlescapeGame::handleAI(BattleUnit *unit)
 {
+	BattleReplayScope replayScope(REPLAY_AI);
 	std::ostringstream ss;
 
 	if ((unit->getTimeUnits() <= 5 && !unit->isBrutal()) || unit->getTimeUnits() < 1 || unit->getWantToEndTurn())
@@ -1172,8 +1210,16 @@ bool BattlescapeGame::playableUnitSelected() const
  */
 void BattlescapeGame::handleState()
 {
+	if (_replay)
+	{
+		_replay->play(this);
+	}
 	if (!_states.empty())
 	{
+		if (_replay)
+		{
+			_replay->step();
+		}
 		// end turn request?
 		if (_states.front() == 0)
 		{
@@ -3441,4 +3487,63 @@ bool BattlescapeGame::getPanicHandled() const
 	return _playerPanicHandled;
 }
 
+/**
+ * Is the battle played back from a replay?
+ * @return True while the replay runs, player input is ignored then.
+ */
+bool BattlescapeGame::isReplaying() const
+{
+	return _replay && _replay->isPlaying();
+}
+
+/**
+ * Records a player command with the current action, if the battle is recorded.
+ * @param command Command given by the player.
+ * @param pos Position on the map, if the command needs one.
+ * @param arg Extra argument of the command.
+ */
+void BattlescapeGame::recordCommand(BattleReplayCommand command, Position pos, int arg)
+{
+	if (_replay && _replay->isRecording())
+	{
+		_replay->record(this, command, pos, arg);
+	}
+}
+
+/**
+ * Stops recording the battle, if it is recorded.
+ * @param input Input that cannot be recorded, for the log.
+ */
+void BattlescapeGame::stopRecording(const std::string &input)
+{
+	if (_replay)
+	{
+		_replay->stopRecording(input);
+	}
+}
+
+/**
+ * Watches a screen whose inputs are not recorded, if the battle is recorded.
+ * Checked by checkUnrecorded() when the battlescape is back.
+ * @param screen Name of the screen, for the log.
+ */
+void BattlescapeGame::watchUnrecorded(const std::string &screen)
+{
+	if (_replay)
+	{
+		_replay->watch(_save, screen);
+	}
+}
+
+/**
+ * Stops recording if the watched screen changed the battle.
+ */
+void BattlescapeGame::checkUnrecorded()
+{
+	if (_replay)
+	{
+		_replay->checkWatched(_save);
+	}
+}
+
 }
@@ -39,6 +39,9 @@ class Mod;
 class InfoboxOKState;
 class SoldierDiary;
 class RuleSkill;
+class BattleReplay;
+class AIPlanner;
+enum BattleReplayCommand : Uint8;
 
 struct BattleActionCost : RuleItemUseCost
 {
@@ -173,6 +176,8 @@ private:
 	bool _endTurnRequested;
 	bool _endConfirmationHandled;
 	bool _allEnemiesNeutralized;
+	BattleReplay *_replay;
+	AIPlanner *_aiPlanner;
 
 	SingleRun _endTurnProcessed;
 	SingleRun _triggerProcessed;
@@ -322,6 +327,20 @@ public:
 	void resetAllEnemiesNeutralized() { _allEnemiesNeutralized = false; }
 	/// Allows AI to tell us which unit should be selected next
 	void setNextUnitToSelect(BattleUnit *unit);
+	/// Gets the replay of this battle, if any.
+	BattleReplay *getReplay() const { return _replay; }
+	/// Is the battle played back from a replay?
+	bool isReplaying() const;
+	/// Gets the planner of the alien turn, if any.
+	AIPlanner *getAIPlanner() const { return _aiPlanner; }
+	/// Records a player command, if the battle is recorded.
+	void recordCommand(BattleReplayCommand command, Position pos = Position(-1, -1, -1), int arg = 0);
+	/// Stops recording the battle after an input that cannot be recorded.
+	void stopRecording(const std::string &input);
+	/// Watches a screen whose inputs are not recorded, if the battle is recorded.
+	void watchUnrecorded(const std::string &screen);
+	/// Stops recording if the watched screen changed the battle.
+	void checkUnrecorded();
 	/// Returns which unit the AI wanted to select next
 	BattleUnit *getNextUnitToSelect();
 };
@@ -88,6 +88,10 @@
 #include "../Mod/RuleVideo.h"
 #include <algorithm>
 #include "../Basescape/SoldiersAIState.h"
+#include "BattleReplay.h"
+#include "AIPlanner.h"
+#include "AIModule.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -768,6 +772,7 @@ void BattlescapeState::init()
 	}
 
 	State::init();
+	_battleGame->checkUnrecorded();
 	_animTimer->start();
 	_gameTimer->start();
 	_map->setFocus(true);
@@ -850,19 +855,49 @@ void BattlescapeState::think()
 		if (_popups.empty())
 		{
 			State::think();
+			if (_battleGame->isReplaying() || canSkipAnimations())
+			{
+				// run the battle without animations, as many steps as fit in a frame
+				BattleReplayScope replayScope(REPLAY_SIMULATION);
+				Uint64 end = Profiler::now() + FAST_FORWARD_BUDGET;
+				do
+				{
+					_battleGame->think();
+					_battleGame->handleState();
+				}
+				while ((_battleGame->isReplaying() || canSkipAnimations()) && _popups.empty() && _game->isState(this) && Profiler::now() < end);
+				popped = false;
+				return;
+			}
 			_battleGame->think();
 			_animTimer->think(this, 0);
 			_gameTimer->think(this, 0);
 			if (popped)
 			{
+				_battleGame->recordCommand(BRC_NON_TARGET);
 				_battleGame->handleNonTargetAction();
 				popped = false;
 			}
+			if (_battleGame->getAIPlanner() && _save->getSide() == FACTION_PLAYER && !_battleGame->isBusy())
+			{
+				// plan the alien turn while the player is thinking
+				_battleGame->getAIPlanner()->think(Profiler::now() + AIPlanner::FRAME_BUDGET);
+			}
+		}
+		else if (_battleGame->isReplaying())
+		{
+			// popups only come from player input, which the replay ignores
+			for (auto& popup : _popups)
+			{
+				delete popup.first;
+			}
+			_popups.clear();
 		}
 		else
 		{
 			// Handle popups
-			_game->pushState(*_popups.begin());
+			_battleGame->watchUnrecorded(_popups.front().second);
+			_game->pushState(_popups.front().first);
 			_popups.erase(_popups.begin());
 			popped = true;
 			return;
@@ -1049,9 +1084,13 @@ void BattlescapeState::mapClick(Action *action)
 		if (_isMouseScrolled) return;
 	}
 
+	// the replay is in control
+	if (_battleGame->isReplaying()) return;
+
 	// right-click aborts walking state
 	if (_game->isRightClick(action))
 	{
+		_battleGame->recordCommand(BRC_CANCEL);
 		if (_battleGame->cancelCurrentAction())
 		{
 			return;
@@ -1079,10 +1118,12 @@ void BattlescapeState::mapClick(Action *action)
 	{
 		if (_game->isRightClick(action, true) && playableUnitSelected())
 		{
+			_battleGame->recordCommand(BRC_SECONDARY, pos);
 			_battleGame->secondaryAction(pos);
 		}
 		else if (_game->isLeftClick(action, true))
 		{
+			_battleGame->recordCommand(BRC_PRIMARY, pos);
 			_battleGame->primaryAction(pos);
 		}
 		else if (_game->isMiddleClick(action, true))
@@ -1094,7 +1135,7 @@ void BattlescapeState::mapClick(Action *action)
 				if (_save->getDebugMode() && _game->isCtrlPressed())
 				{
 					// mind probe
-					popup(new UnitInfoState(bu, this, false, true));
+					popup(new UnitInfoState(bu, this, false, true), "mind probe");
 				}
 				else
 				{
@@ -1121,8 +1162,9 @@ void BattlescapeState::mapIn(Action *)
  */
 void BattlescapeState::btnUnitUpClick(Action *)
 {
-	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_UP))
+	if (playableUnitSelected() && !_battleGame->isReplaying() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_UP))
 	{
+		_battleGame->recordCommand(BRC_UP);
 		_battleGame->cancelAllActions();
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_UP);
 	}
@@ -1134,8 +1176,9 @@ void BattlescapeState::btnUnitUpClick(Action *)
  */
 void BattlescapeState::btnUnitDownClick(Action *)
 {
-	if (playableUnitSelected() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_DOWN))
+	if (playableUnitSelected() && !_battleGame->isReplaying() && _save->getPathfinding()->validateUpDown(_save->getSelectedUnit(), _save->getSelectedUnit()->getPosition(), Pathfinding::DIR_DOWN))
 	{
+		_battleGame->recordCommand(BRC_DOWN);
 		_battleGame->cancelAllActions();
 		_battleGame->moveUpDown(_save->getSelectedUnit(), Pathfinding::DIR_DOWN);
 	}
@@ -1195,6 +1238,7 @@ void BattlescapeState::btnKneelClick(Action *)
 		BattleUnit *bu = _save->getSelectedUnit();
 		if (bu)
 		{
+			_battleGame->recordCommand(BRC_KNEEL);
 			_battleGame->kneel(bu);
 			toggleKneelButton(bu);
 
@@ -1231,6 +1275,7 @@ void BattlescapeState::btnInventoryClick(Action *)
 		&& (_save->getSelectedUnit()->hasInventory() || _save->getDebugMode()))
 	{
 		_battleGame->cancelAllActions();
+		_battleGame->watchUnrecorded("inventory");
 		_game->pushState(new InventoryState(true, this, 0));
 	}
 }
@@ -1395,6 +1440,7 @@ void BattlescapeState::btnEndTurnClick(Action *)
 		toggleTouchButtons(true, false);
 
 		_txtTooltip->setText("");
+		_battleGame->recordCommand(BRC_END_TURN);
 		_battleGame->requestEndTurn(false);
 	}
 }
@@ -1460,7 +1506,7 @@ void BattlescapeState::btnStatsClick(Action *action)
 			else
 			{
 				_battleGame->cancelAllActions();
-				popup(new UnitInfoState(_save->getSelectedUnit(), this, false, false));
+				popup(new UnitInfoState(_save->getSelectedUnit(), this, false, false), "unit info");
 			}
 		}
 	}
@@ -1725,6 +1771,8 @@ void BattlescapeState::toggleTouchButtons(bool deactivate, bool tryToReactivate)
  */
 void BattlescapeState::btnLaunchClick(Action *action)
 {
+	if (_battleGame->isReplaying()) return;
+	_battleGame->recordCommand(BRC_LAUNCH);
 	_battleGame->launchAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1735,6 +1783,8 @@ void BattlescapeState::btnLaunchClick(Action *action)
  */
 void BattlescapeState::btnPsiClick(Action *action)
 {
+	if (_battleGame->isReplaying()) return;
+	_battleGame->recordCommand(BRC_PSI);
 	_battleGame->psiButtonAction();
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1785,7 +1835,7 @@ void BattlescapeState::btnSkillsClick(Action *action)
 {
 	if (playableUnitSelected() && !_battleGame->isBusy())
 	{
-		popup(new SkillMenuState(_battleGame->getCurrentAction(), _icons->getX(), _icons->getY() + 16));
+		popup(new SkillMenuState(_battleGame->getCurrentAction(), _icons->getX(), _icons->getY() + 16), "skill menu");
 	}
 	action->getDetails()->type = SDL_NOEVENT; // consume the event
 }
@@ -1804,14 +1854,15 @@ void BattlescapeState::btnReserveClick(Action *action)
 		Action a = Action(&ev, 0.0, 0.0, 0, 0);
 		action->getSender()->mousePress(&a, this);
 
-		if (_reserve == _btnReserveNone)
-			_battleGame->setTUReserved(BA_NONE);
-		else if (_reserve == _btnReserveSnap)
-			_battleGame->setTUReserved(BA_SNAPSHOT);
+		BattleActionType reserved = BA_NONE;
+		if (_reserve == _btnReserveSnap)
+			reserved = BA_SNAPSHOT;
 		else if (_reserve == _btnReserveAimed)
-			_battleGame->setTUReserved(BA_AIMEDSHOT);
+			reserved = BA_AIMEDSHOT;
 		else if (_reserve == _btnReserveAuto)
-			_battleGame->setTUReserved(BA_AUTOSHOT);
+			reserved = BA_AUTOSHOT;
+		_battleGame->recordCommand(BRC_RESERVE, Position(-1, -1, -1), reserved);
+		_battleGame->setTUReserved(reserved);
 
 		// update any path preview
 		if (_battleGame->getPathfinding()->isPathPreviewed())
@@ -1827,7 +1878,12 @@ void BattlescapeState::btnReserveClick(Action *action)
  */
 void BattlescapeState::btnReloadClick(Action *)
 {
-	if (playableUnitSelected() && _save->getSelectedUnit()->reloadAmmo())
+	if (!playableUnitSelected() || _battleGame->isReplaying())
+	{
+		return;
+	}
+	_battleGame->recordCommand(BRC_RELOAD);
+	if (_save->getSelectedUnit()->reloadAmmo())
 	{
 		_game->getMod()->getSoundByDepth(_save->getDepth(), _save->getSelectedUnit()->getReloadSound())->play(-1, getMap()->getSoundAngle(_save->getSelectedUnit()->getPosition()));
 		updateSoldierInfo();
@@ -1853,7 +1909,10 @@ void BattlescapeState::btnSelectMusicTrackClick(Action *)
 void BattlescapeState::btnPersonalLightingClick(Action *)
 {
 	if (allowButtons())
+	{
+		_battleGame->recordCommand(BRC_LIGHT);
 		_save->getTileEngine()->togglePersonalLighting();
+	}
 }
 
 /**
@@ -1876,6 +1935,37 @@ bool BattlescapeState::playableUnitSelected()
 	return _save->getSelectedUnit() != 0 && allowButtons();
 }
 
+/**
+ * Determines whether the battle can skip animations, because it is the turn of
+ * another side and nothing going on is visible to the player. Stops as soon as
+ * the acting unit is spotted, something is shot or explodes, or a door opens, a unit
+ * is hurt or fire or smoke changes where the player can see it.
+ * @return Whether the battle can run without animations.
+ */
+bool BattlescapeState::canSkipAnimations()
+{
+	if (!Options::oxceTurboAITurns || _save->getSide() == FACTION_PLAYER || _save->getDebugMode())
+	{
+		_save->resetVisibleChange();
+		return false;
+	}
+	if (_map->getProjectile() || !_map->getExplosions()->empty())
+	{
+		return false;
+	}
+	// a door, hit, fire or smoke the player can see is shown until the action causing it is over
+	if (_save->getVisibleChange())
+	{
+		if (_battleGame->isBusy())
+		{
+			return false;
+		}
+		_save->resetVisibleChange();
+	}
+	BattleUnit *unit = _save->getSelectedUnit();
+	return unit == 0 || !unit->getVisible();
+}
+
 /**
  * Draw hand item with ammo number.
  */
@@ -2401,7 +2491,7 @@ void BattlescapeState::handleItemClick(BattleItem *item, bool middleClick)
 		else
 		{
 			_battleGame->getCurrentAction()->weapon = item;
-			popup(new ActionMenuState(_battleGame->getCurrentAction(), _icons->getX(), _icons->getY() + 16));
+			popup(new ActionMenuState(_battleGame->getCurrentAction(), _icons->getX(), _icons->getY() + 16), "action menu");
 			if (item->getRules()->getBattleType() == BT_FIREARM)
 			{
 				_battleGame->playUnitResponseSound(_battleGame->getCurrentAction()->actor, 2); // "select weapon" sound
@@ -2841,6 +2931,12 @@ inline void BattlescapeState::handle(Action *action)
 					{
 						saveAIMap();
 					}
+					// f8 - script profile
+					else if (key == Options::keyScriptProfiler && Options::oxceScriptProfiler)
+					{
+						ScriptProfiler::dump("on demand");
+						debug("Script profile saved to log");
+					}
 				}
 				// quick save and quick load
 				if (!_game->getSavedGame()->isIronman() && !_save->isPreview())
@@ -3200,10 +3296,11 @@ void BattlescapeState::saveVoxelMap()
  * Adds a new popup window to the queue
  * (this prevents popups from overlapping).
  * @param state Pointer to popup state.
+ * @param screen Name of the popup, for the battle replay.
  */
-void BattlescapeState::popup(State *state)
+void BattlescapeState::popup(State *state, const std::string &screen)
 {
-	_popups.push_back(state);
+	_popups.push_back(std::make_pair(state, screen));
 }
 
 /**
@@ -3229,6 +3326,15 @@ void BattlescapeState::finishBattle(bool abort, int inExitArea)
 	// reset touch flags
 	_game->resetTouchButtonFlags();
 
+	ScriptProfiler::dump("end of battle");
+	ScriptProfiler::reset();
+	AIModule::dumpBudgetStats("end of battle");
+
+	if (_battleGame->getReplay())
+	{
+		_battleGame->getReplay()->finish(_save);
+	}
+
 	// dear civilians and summoned player units,
 	// please drop all borrowed xcom equipment now, so that we can recover it
 	// thank you!
@@ -3430,7 +3536,8 @@ bool BattlescapeState::getMouseOverIcons() const
  */
 bool BattlescapeState::allowButtons(bool allowSaving) const
 {
-	return ((allowSaving || _save->getSide() == FACTION_PLAYER || _save->getDebugMode())
+	return !_battleGame->isReplaying()
+		&& ((allowSaving || _save->getSide() == FACTION_PLAYER || _save->getDebugMode())
 		&& (_battleGame->getPanicHandled() || _firstInit )
 		&& (allowSaving || !_battleGame->isBusy() || _firstInit)
 		&& (_map->getProjectile() == 0));
@@ -3449,6 +3556,7 @@ void BattlescapeState::btnReserveKneelClick(Action *action)
 		ev.button.button = SDL_BUTTON_LEFT;
 		Action a = Action(&ev, 0.0, 0.0, 0, 0);
 		action->getSender()->mousePress(&a, this);
+		_battleGame->recordCommand(BRC_RESERVE_KNEEL, Position(-1, -1, -1), !_battleGame->getKneelReserved());
 		_battleGame->setKneelReserved(!_battleGame->getKneelReserved());
 
 		_btnReserveKneel->toggle(_battleGame->getKneelReserved());
@@ -3476,6 +3584,7 @@ void BattlescapeState::btnZeroTUsClick(Action *action)
 		action->getSender()->mousePress(&a, this);
 		if (_battleGame->getSave()->getSelectedUnit())
 		{
+			_battleGame->recordCommand(BRC_ZERO_TU);
 			_battleGame->getSave()->getSelectedUnit()->clearTimeUnits();
 			updateSoldierInfo();
 		}
@@ -3810,6 +3919,10 @@ void BattlescapeState::stopScrolling(Action *action)
  */
 void BattlescapeState::autosave(int currentTurn)
 {
+	if (_battleGame->isReplaying())
+	{
+		return;
+	}
 	_autosave = currentTurn;
 }
 
@@ -69,6 +69,9 @@ private:
 	NumberText *_numVisibleUnit[VISIBLE_MAX];
 	BattleUnit *_visibleUnit[VISIBLE_MAX];
 
+	/// Time in microseconds the battle may spend skipping animations in one frame.
+	static const Uint64 FAST_FORWARD_BUDGET = 20000;
+
 	WarningMessage *_warning;
 	Text *_txtName;
 	NumberText *_numTimeUnits, *_numEnergy, *_numHealth, *_numMorale, *_numLayers;
@@ -83,7 +86,7 @@ private:
 	Text *_txtDebug, *_txtTooltip;
 	Uint8 _tooltipDefaultColor;
 	Uint8 _medikitRed, _medikitGreen, _medikitBlue, _medikitOrange;
-	std::vector<State*> _popups;
+	std::vector<std::pair<State*, std::string>> _popups; // popup state, name of the screen for the battle replay
 	BattlescapeGame *_battleGame;
 	bool _firstInit, _paletteResetNeeded, _paletteResetRequested;
 	bool _isMouseScrolling, _isMouseScrolled;
@@ -211,6 +214,8 @@ public:
 	void btnNightVisionClick(Action *action);
 	/// Determines whether a playable unit is selected.
 	bool playableUnitSelected();
+	/// Determines whether the battle can skip animations the player would not see.
+	bool canSkipAnimations();
 	/// Updates soldier name/rank/tu/energy/health/morale.
 	void updateSoldierInfo(bool checkFOV = true);
 	/// Updates the special/psi/skill button display based on the battle unit
@@ -240,7 +245,7 @@ public:
 	/// Handles keypresses.
 	void handle(Action *action) override;
 	/// Displays a popup window.
-	void popup(State *state);
+	void popup(State *state, const std::string &screen);
 	/// Finishes a battle.
 	void finishBattle(bool abort, int inExitArea);
 	/// Show the launch button.
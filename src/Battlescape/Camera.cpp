@@ -347,7 +347,7 @@ void Camera::scrollXY(int x, int y, bool redraw)
 	while (true);
 
 	_map->refreshSelectorPosition();
-	if (redraw) _map->invalidate();
+	if (redraw) _map->invalidateScroll();
 }
 
 
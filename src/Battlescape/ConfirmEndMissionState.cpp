@@ -26,6 +26,7 @@
 #include "../Savegame/SavedBattleGame.h"
 #include "BattlescapeState.h"
 #include "BattlescapeGame.h"
+#include "BattleReplay.h"
 #include "../Engine/Options.h"
 
 namespace OpenXcom
@@ -102,6 +103,7 @@ ConfirmEndMissionState::~ConfirmEndMissionState()
 void ConfirmEndMissionState::btnOkClick(Action *)
 {
 	_game->popState();
+	_parent->recordCommand(BRC_END_TURN);
 	_parent->requestEndTurn(false);
 }
 
@@ -114,5 +116,18 @@ void ConfirmEndMissionState::btnCancelClick(Action *)
 	_game->popState();
 }
 
+/**
+ * Closes the window during a replay, the recorded
+ * answer is replayed as an end turn command.
+ */
+void ConfirmEndMissionState::think()
+{
+	State::think();
+	if (_parent->isReplaying())
+	{
+		btnCancelClick(0);
+	}
+}
+
 
 }
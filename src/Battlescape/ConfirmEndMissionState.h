@@ -50,7 +50,8 @@ public:
 	void btnOkClick(Action *action);
 	/// Handler for clicking the Cancel button.
 	void btnCancelClick(Action *action);
-
+	/// Closes the window during a replay.
+	void think() override;
 };
 
 }
@@ -25,6 +25,7 @@
 #include "../Engine/Options.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
+#include "BattlescapeGame.h"
 
 namespace OpenXcom
 {
@@ -89,4 +90,16 @@ void InfoboxOKState::btnOkClick(Action *)
 	_game->popState();
 }
 
+/**
+ * Closes the window during a replay, nobody is there to click OK.
+ */
+void InfoboxOKState::think()
+{
+	State::think();
+	if (_game->getSavedGame()->getSavedBattle()->getBattleGame()->isReplaying())
+	{
+		btnOkClick(0);
+	}
+}
+
 }
@@ -43,6 +43,8 @@ public:
 	~InfoboxOKState();
 	/// Handler for clicking the OK button.
 	void btnOkClick(Action *action);
+	/// Closes the window during a replay.
+	void think() override;
 };
 
 }
@@ -24,6 +24,7 @@
 #include "../Engine/Action.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
+#include "BattlescapeGame.h"
 
 namespace OpenXcom
 {
@@ -99,6 +100,12 @@ void InfoboxState::handle(Action *action)
  */
 void InfoboxState::think()
 {
+	// nobody watches a replay, don't wait for the message
+	if (_game->getSavedGame()->getSavedBattle()->getBattleGame()->isReplaying())
+	{
+		close();
+		return;
+	}
 	_timer->think(this, 0);
 }
 
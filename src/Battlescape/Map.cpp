@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "Map.h"
+#include <climits>
+#include <cstring>
 #include "Camera.h"
 #include "UnitSprite.h"
 #include "ItemSprite.h"
@@ -36,6 +38,8 @@
 #include "../Engine/Screen.h"
 #include "../Engine/ShaderDraw.h"
 #include "../Engine/ShaderMove.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/ThreadPool.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -108,7 +112,13 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_game(game), _arrow(0), _anyIndicator(false), _isAltPressed(false),
 	_selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0),
 	_projectile(0), _followProjectile(true), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight),
-	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _showObstacles(false)
+	_unitDying(false), _smoothingEngaged(false), _flashScreen(false), _bgColor(15), _projectileSet(0), _showObstacles(false),
+	_partialRedraw(false), _lastFrameValid(false), _lastFrameAlt(false), _lastFrameOverIcons(false), _lastFrameAllLayers(false),
+	_lastFrameSelectorX(0), _lastFrameSelectorY(0), _lastFrameAnimFrame(0), _lastFrameCursorSize(0), _lastFrameCursorType(CT_NONE),
+	_lastFrameTileChanges(0), _lastFrameSelectedUnit(0), _lastFrameWaypoints(0), _animTicksSinceDraw(0), _regionSurface(0),
+	_terrainLayer(0), _drawingTerrainLayer(false), _terrainLayerAllLayers(false), _terrainLayerTileChanges(0),
+	_terrainLayerFadeShade(0), _terrainLayerNvColor(0), _terrainLayerDebugVisionMode(0), _terrainLayerDebugMode(false),
+	_shadeCacheActive(false), _shadeCacheShared(false), _shadeCacheStamp(0), _renderPool(0)
 {
 	_iconHeight = _game->getMod()->getInterface("battlescape")->getElement("icons")->h;
 	_iconWidth = _game->getMod()->getInterface("battlescape")->getElement("icons")->w;
@@ -215,6 +225,7 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 
 	_vaporParticlesInit.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
 	_vaporParticles.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
+	_terrainLayerStale.resize(_save->getMapSizeXYZ());
 }
 
 /**
@@ -230,6 +241,9 @@ Map::~Map()
 	delete _message;
 	delete _camera;
 	delete _txtAccuracy;
+	delete _renderPool;
+	delete _regionSurface;
+	delete _terrainLayer;
 }
 
 /**
@@ -281,28 +295,42 @@ void Map::think()
 }
 
 /**
- * Draws the whole map, part by part.
+ * Fills a surface with the map background.
+ * @param surface Surface to fill.
  */
-void Map::draw()
+void Map::fillBackground(Surface *surface)
 {
-	if (!_redraw)
-	{
-		return;
-	}
-
 	// normally we'd call for a Surface::draw();
 	// but we don't want to clear the background with colour 0, which is transparent (aka black)
 	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
 	// Note: un-hardcoded the color from 15 to ruleset value, default 15
-	_redraw = false;
 	ShaderDrawFunc(
 		[](Uint8& dest, Uint8 color)
 		{
 			dest = color;
 		},
-		ShaderSurface(this),
+		ShaderSurface(surface),
 		ShaderScalar<Uint8>(Palette::blockOffset(0) + _bgColor)
 	);
+}
+
+/**
+ * Draws the whole map, part by part. If the map was only
+ * invalidated by a camera pan, a selector move or an animation
+ * tick, just the parts of the previous frame that changed are drawn.
+ * Otherwise the map is drawn over the static terrain layer if it can be.
+ */
+void Map::draw()
+{
+	if (!_redraw && !_partialRedraw)
+	{
+		return;
+	}
+	const bool fullRedraw = _redraw;
+	_redraw = false;
+	_partialRedraw = false;
+	FrameProfilerScope profile(FRAME_TERRAIN);
+	_isAltPressed = _game->isAltPressed(true);
 
 	Tile *t;
 
@@ -331,12 +359,536 @@ void Map::draw()
 
 	if ((_save->getSelectedUnit() && _save->getSelectedUnit()->getVisible()) || _unitDying || _save->getSide() == FACTION_PLAYER || _save->getDebugMode() || _projectileInFOV || _explosionInFOV)
 	{
-		drawTerrain(this);
+		if (!(!fullRedraw && drawChanged()) && !drawLayered() && !drawStrips())
+		{
+			fillBackground(this);
+			drawTerrain(this, _camera);
+		}
+		_lastFrameValid = true;
+		_lastFrameOffset = _camera->getMapOffset();
+		_lastFrameSelectorX = _selectorX;
+		_lastFrameSelectorY = _selectorY;
+		_lastFrameAnimFrame = _animFrame;
+		_lastFrameCursorType = _cursorType;
+		_lastFrameCursorSize = _cursorSize;
+		_lastFrameAlt = _isAltPressed;
+		_lastFrameOverIcons = _save->getBattleState()->getMouseOverIcons();
+		_lastFrameAllLayers = _camera->getShowAllLayers();
+		_lastFrameTileChanges = _save->getTileChanges();
+		_lastFrameSelectedUnit = _save->getSelectedUnit();
+		_lastFrameWaypoints = _waypoints.size();
 	}
 	else
 	{
+		fillBackground(this);
 		_message->blit(this->getSurface());
+		_lastFrameValid = false;
+	}
+	_animTicksSinceDraw = 0;
+	_animatedTiles.clear();
+}
+
+/**
+ * Blits the map onto another surface, drawing the
+ * parts of it that changed since the last blit first.
+ * @param surface Pointer to surface to blit onto.
+ */
+void Map::blit(SDL_Surface *surface)
+{
+	if (_partialRedraw && !_redraw && _visible && !_hidden)
+	{
+		draw();
+	}
+	Surface::blit(surface);
+}
+
+/**
+ * Redraws the map on the next blit after the camera was
+ * moved, without anything else on it changing, so the
+ * previous frame can be reused. Any other invalidation
+ * redraws the whole map.
+ */
+void Map::invalidateScroll()
+{
+	_partialRedraw = true;
+}
+
+/**
+ * Reuses the previous frame when only the camera position, the
+ * selector or the animation frame changed since it was drawn: the
+ * frame is shifted by the camera movement and only the newly exposed
+ * strips, the old and new selector areas and the animated tiles are
+ * drawn again. Anything in motion (projectiles, explosions, walking
+ * or dying units), any change to the tiles or too many changed areas
+ * force a full redraw.
+ * @return True if the map was drawn.
+ */
+bool Map::drawChanged()
+{
+	if (!Options::oxceBattleScrollBlit || !_lastFrameValid)
+	{
+		return false;
+	}
+	const Position offset = _camera->getMapOffset();
+	const int dx = offset.x - _lastFrameOffset.x;
+	const int dy = offset.y - _lastFrameOffset.y;
+	const int width = getWidth();
+	const int height = getHeight();
+	const bool animated = _animFrame != _lastFrameAnimFrame;
+	if (offset.z != _lastFrameOffset.z || std::abs(dx) >= width / 2 || std::abs(dy) >= height / 2 ||
+		_cursorType != _lastFrameCursorType || _cursorSize != _lastFrameCursorSize ||
+		_isAltPressed != _lastFrameAlt || _save->getBattleState()->getMouseOverIcons() != _lastFrameOverIcons ||
+		_camera->getShowAllLayers() != _lastFrameAllLayers || _save->getTileChanges() != _lastFrameTileChanges ||
+		_save->getSelectedUnit() != _lastFrameSelectedUnit || _waypoints.size() != _lastFrameWaypoints ||
+		_projectile || !_explosions.empty() || _unitDying || _save->getBattleGame()->isBusy() || _save->getTileEngine()->getMovingUnit())
+	{
+		return false;
+	}
+
+	std::vector<SDL_Rect> areas;
+	if (dx > 0)
+	{
+		areas.push_back(SDL_Rect{ 0, 0, (Uint16)dx, (Uint16)height });
+	}
+	else if (dx < 0)
+	{
+		areas.push_back(SDL_Rect{ (Sint16)(width + dx), 0, (Uint16)-dx, (Uint16)height });
+	}
+	if (dy > 0)
+	{
+		areas.push_back(SDL_Rect{ 0, 0, (Uint16)width, (Uint16)dy });
+	}
+	else if (dy < 0)
+	{
+		areas.push_back(SDL_Rect{ 0, (Sint16)(height + dy), (Uint16)width, (Uint16)-dy });
+	}
+	if (animated || _selectorX != _lastFrameSelectorX || _selectorY != _lastFrameSelectorY)
+	{
+		// the cursor is animated too
+		areas.push_back(getSelectorArea(_lastFrameSelectorX, _lastFrameSelectorY));
+		areas.push_back(getSelectorArea(_selectorX, _selectorY));
+	}
+	if (animated && !addAnimatedAreas(areas))
+	{
+		return false;
+	}
+	if (!areAreasCheap(areas))
+	{
+		return false;
+	}
+
+	// shift the old frame, rows are moved in the order that doesn't overwrite rows still to be moved
+	Uint8 *pixels = getBuffer();
+	const int pitch = getPitch();
+	const int rowWidth = width - std::abs(dx);
+	for (int i = 0; i < height - std::abs(dy); ++i)
+	{
+		int y = dy > 0 ? height - 1 - i : i;
+		Uint8 *dest = pixels + y * pitch + std::max(dx, 0);
+		const Uint8 *src = pixels + (y - dy) * pitch + std::max(-dx, 0);
+		std::memmove(dest, src, rowWidth);
+	}
+
+	for (const auto& area : areas)
+	{
+		drawRegion(area);
+	}
+	return true;
+}
+
+/**
+ * Adds the screen areas that change with the animation frame:
+ * tiles whose sprites were animated, and tiles with fire, smoke,
+ * units or items on them, as unit and item sprites can be animated
+ * by scripts.
+ * @param areas Areas to redraw.
+ * @return False if the whole map has to be redrawn instead.
+ */
+bool Map::addAnimatedAreas(std::vector<SDL_Rect> &areas) const
+{
+	// obstacles pulse, scanner arrows bob and vapor drifts all over the map
+	if (_animTicksSinceDraw > 1 || _showObstacles || _isAltPressed || hasVaporParticles())
+	{
+		return false;
+	}
+	addTileAreas(areas, _animatedTiles);
+	return true;
+}
+
+/**
+ * Adds the screen areas of some tiles, and of the tiles in view with
+ * fire, smoke, units or items on them. Areas that overlap are merged.
+ * @param areas Areas to redraw.
+ * @param tiles Positions of the tiles to add besides the ones in view.
+ */
+void Map::addTileAreas(std::vector<SDL_Rect> &areas, std::vector<Position> tiles) const
+{
+	int beginX, endX, beginY, endY, endZ;
+	getTerrainBounds(this, _camera, beginX, endX, beginY, endY, endZ);
+	endX = std::min(endX, _save->getMapSizeX() - 1);
+	endY = std::min(endY, _save->getMapSizeY() - 1);
+	for (int z = 0; z <= endZ; ++z)
+	{
+		for (int x = beginX; x <= endX; ++x)
+		{
+			for (int y = beginY; y <= endY; ++y)
+			{
+				Tile *tile = _save->getTile(Position(x, y, z));
+				if (tile->getFire() || tile->getSmoke() || tile->getUnit() || !tile->getInventory()->empty())
+				{
+					tiles.push_back(Position(x, y, z));
+				}
+			}
+		}
+	}
+
+	const Position offset = _camera->getMapOffset();
+	const size_t first = areas.size();
+	for (const auto& pos : tiles)
+	{
+		Position screenPosition;
+		_camera->convertMapToScreen(pos, &screenPosition);
+		screenPosition += offset;
+		// units and their arrows reach up to a tile above their own
+		int left = std::max(0, (int)screenPosition.x);
+		int top = std::max(0, screenPosition.y - _spriteHeight);
+		int right = std::min(getWidth(), screenPosition.x + _spriteWidth);
+		int bottom = std::min(getHeight(), screenPosition.y + _spriteHeight);
+		if (left >= right || top >= bottom)
+		{
+			continue;
+		}
+		SDL_Rect area{ (Sint16)left, (Sint16)top, (Uint16)(right - left), (Uint16)(bottom - top) };
+
+		// merge with an area that is cheaper to draw together with it
+		for (size_t i = first; i < areas.size(); ++i)
+		{
+			SDL_Rect &other = areas[i];
+			int mergedLeft = std::min(left, (int)other.x);
+			int mergedTop = std::min(top, (int)other.y);
+			int mergedRight = std::max(right, other.x + other.w);
+			int mergedBottom = std::max(bottom, other.y + other.h);
+			int merged = (mergedRight - mergedLeft + _spriteWidth * 2) * (mergedBottom - mergedTop + _spriteHeight * 4);
+			int separate = (area.w + _spriteWidth * 2) * (area.h + _spriteHeight * 4) + (other.w + _spriteWidth * 2) * (other.h + _spriteHeight * 4);
+			if (merged <= separate)
+			{
+				other = SDL_Rect{ (Sint16)mergedLeft, (Sint16)mergedTop, (Uint16)(mergedRight - mergedLeft), (Uint16)(mergedBottom - mergedTop) };
+				area.w = 0;
+				break;
+			}
+		}
+		if (area.w)
+		{
+			areas.push_back(area);
+		}
+	}
+}
+
+/**
+ * Checks if there are vapor particles anywhere on the map.
+ * @return True if there are.
+ */
+bool Map::hasVaporParticles() const
+{
+	for (const auto& vapor : _vaporParticles)
+	{
+		if (!vapor.empty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Checks if every area is cheap enough to draw, compared to the whole map.
+ * @param areas Areas to redraw.
+ * @return True if drawing the areas is cheaper.
+ */
+bool Map::areAreasCheap(const std::vector<SDL_Rect> &areas) const
+{
+	// every area is drawn with a margin, past half the map drawing it whole is cheaper
+	int cost = 0;
+	for (const auto& area : areas)
+	{
+		cost += (area.w + _spriteWidth * 2) * (area.h + _spriteHeight * 4);
+	}
+	return cost <= getWidth() * getHeight() / 2;
+}
+
+/**
+ * Draws the whole map from the static terrain layer: the terrain as
+ * seen from the current camera position, without units, items, smoke
+ * or the cursor. Only the parts of the map with these on them are
+ * drawn over the layer. The layer is drawn again when the camera
+ * moves or the tiles change (destruction, doors, lighting and
+ * visibility all count as tile changes), or when the shading does.
+ * Tiles animated since the layer was drawn are drawn over it too.
+ * @return True if the map was drawn.
+ */
+bool Map::drawLayered()
+{
+	if (!Options::oxceBattleTerrainLayer || _projectile || !_explosions.empty() || !_waypoints.empty() ||
+		_save->getPathfinding()->isPathPreviewed() || _showObstacles || _isAltPressed || hasVaporParticles())
+	{
+		return false;
+	}
+	const Position offset = _camera->getMapOffset();
+	bool valid = _terrainLayer && _terrainLayer->getWidth() == getWidth() && _terrainLayer->getHeight() == getHeight() &&
+		offset == _terrainLayerOffset && _camera->getShowAllLayers() == _terrainLayerAllLayers &&
+		_save->getTileChanges() == _terrainLayerTileChanges && _fadeShade == _terrainLayerFadeShade &&
+		_nvColor == _terrainLayerNvColor && _debugVisionMode == _terrainLayerDebugVisionMode &&
+		_save->getDebugMode() == _terrainLayerDebugMode;
+
+	std::vector<SDL_Rect> areas;
+	if (_cursorType != CT_NONE && !_save->getBattleState()->getMouseOverIcons())
+	{
+		areas.push_back(getSelectorArea(_selectorX, _selectorY));
+	}
+	std::vector<Position> tiles;
+	if (valid)
+	{
+		tiles = _terrainLayerStaleTiles;
+	}
+	BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit();
+	if (movingUnit)
+	{
+		// the unit is drawn between the tiles it walks from and to, and on the level below when it falls
+		const int size = movingUnit->getArmor()->getSize();
+		for (Position pos : { movingUnit->getPosition(), movingUnit->getLastPosition(), movingUnit->getDestination() })
+		{
+			for (int x = 0; x < size; ++x)
+			{
+				for (int y = 0; y < size; ++y)
+				{
+					tiles.push_back(pos + Position(x, y, 0));
+					if (pos.z > 0)
+					{
+						tiles.push_back(pos + Position(x, y, -1));
+					}
+				}
+			}
+		}
+	}
+	addTileAreas(areas, tiles);
+	if (!areAreasCheap(areas))
+	{
+		return false;
+	}
+
+	if (!valid)
+	{
+		if (!_terrainLayer || _terrainLayer->getWidth() != getWidth() || _terrainLayer->getHeight() != getHeight())
+		{
+			delete _terrainLayer;
+			_terrainLayer = new Surface(getWidth(), getHeight());
+			_terrainLayer->setPalette(getPalette());
+		}
+		fillBackground(_terrainLayer);
+		_drawingTerrainLayer = true;
+		drawTerrain(_terrainLayer, _camera);
+		_drawingTerrainLayer = false;
+		_terrainLayerOffset = offset;
+		_terrainLayerAllLayers = _camera->getShowAllLayers();
+		_terrainLayerTileChanges = _save->getTileChanges();
+		_terrainLayerFadeShade = _fadeShade;
+		_terrainLayerNvColor = _nvColor;
+		_terrainLayerDebugVisionMode = _debugVisionMode;
+		_terrainLayerDebugMode = _save->getDebugMode();
+		for (const auto& pos : _terrainLayerStaleTiles)
+		{
+			_terrainLayerStale[_save->getTileIndex(pos)] = false;
+		}
+		_terrainLayerStaleTiles.clear();
+	}
+
+	for (int y = 0; y < getHeight(); ++y)
+	{
+		std::memcpy(getRaw(0, y), _terrainLayer->getRaw(0, y), getWidth());
 	}
+	for (const auto& area : areas)
+	{
+		drawRegion(area);
+	}
+	return true;
+}
+
+/**
+ * Draws a part of the map over the current contents.
+ * The part is rendered with some margin around it, so
+ * sprites of tiles next to it are not culled. The same
+ * surface is reused for parts of the same size.
+ * @param area Part of the map surface to draw.
+ */
+void Map::drawRegion(const SDL_Rect &area)
+{
+	const int x = std::max(0, (int)area.x);
+	const int y = std::max(0, (int)area.y);
+	const int w = std::min(getWidth(), area.x + area.w) - x;
+	const int h = std::min(getHeight(), area.y + area.h) - y;
+	if (w <= 0 || h <= 0)
+	{
+		return;
+	}
+
+	const int left = x - _spriteWidth;
+	const int top = y - _spriteHeight * 2;
+	const int regionWidth = w + _spriteWidth * 2;
+	const int regionHeight = h + _spriteHeight * 4;
+	if (!_regionSurface || _regionSurface->getWidth() != regionWidth || _regionSurface->getHeight() != regionHeight)
+	{
+		delete _regionSurface;
+		_regionSurface = new Surface(regionWidth, regionHeight);
+		_regionSurface->setPalette(getPalette());
+	}
+	fillBackground(_regionSurface);
+
+	Camera camera(*_camera);
+	camera.setMapOffset(_camera->getMapOffset() - Position(left, top, 0));
+	drawTerrain(_regionSurface, &camera);
+
+	for (int i = y; i < y + h; ++i)
+	{
+		std::memcpy(getRaw(x, i), _regionSurface->getRaw(x - left, i - top), w);
+	}
+}
+
+/**
+ * Draws the whole map in vertical strips painted in parallel.
+ * Each strip is drawn on its own surface with some margin, so sprites
+ * of tiles next to it are not culled, and only its own columns are
+ * copied back, so the draw order inside every strip stays the same.
+ * Projectiles move the camera and path markers create surfaces while
+ * drawing, so frames with these (or with explosions) are drawn whole.
+ * @return True if the map was drawn.
+ */
+bool Map::drawStrips()
+{
+	const int threads = ThreadPool::getThreadCount(Options::oxceBattleRenderThreads);
+	const int width = getWidth();
+	const int height = getHeight();
+	// narrower strips would spend most of the time drawing their margins
+	const int count = std::min(threads, width / (_spriteWidth * 4));
+	if (count < 2 || _projectile || !_explosions.empty() || !_waypoints.empty() || _save->getPathfinding()->isPathPreviewed())
+	{
+		return false;
+	}
+	if (!_renderPool || _renderPool->getSize() != threads)
+	{
+		delete _renderPool;
+		_renderPool = new ThreadPool(threads);
+	}
+
+	// workers can't load sprites on first use
+	preloadSprites();
+
+	// all strips share the shade cache, so fill it beforehand and only read it while drawing
+	int beginX, endX, beginY, endY, endZ;
+	getTerrainBounds(this, _camera, beginX, endX, beginY, endY, endZ);
+	prepareShadeCache();
+	for (int z = 0; z <= endZ; ++z)
+	{
+		for (int y = beginY; y < endY; ++y)
+		{
+			for (int x = beginX; x < endX; ++x)
+			{
+				Tile *tile = _save->getTile(Position(x, y, z));
+				if (tile)
+				{
+					reShade(tile);
+				}
+			}
+		}
+	}
+
+	std::vector<Surface> strips;
+	strips.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		const int left = std::max(0, width * i / count - _spriteWidth);
+		const int right = std::min(width, width * (i + 1) / count + _spriteWidth);
+		strips.emplace_back(right - left, height, left, 0);
+		strips.back().setPalette(getPalette());
+	}
+
+	Uint8 *pixels = getBuffer();
+	const int pitch = getPitch();
+	_shadeCacheShared = true;
+	_renderPool->parallelFor(count, [&](int i)
+	{
+		Surface &strip = strips[i];
+		fillBackground(&strip);
+
+		Camera camera(*_camera);
+		camera.setMapOffset(_camera->getMapOffset() - Position(strip.getX(), 0, 0));
+		drawTerrain(&strip, &camera);
+
+		const int x = width * i / count;
+		const int w = width * (i + 1) / count - x;
+		for (int y = 0; y < height; ++y)
+		{
+			std::memcpy(pixels + y * pitch + x, strip.getRaw(x - strip.getX(), y), w);
+		}
+	});
+	_shadeCacheShared = false;
+	_shadeCacheActive = false;
+	return true;
+}
+
+/**
+ * Loads the sprites used by drawTerrain that are loaded
+ * on their first use, so the strips drawn in parallel
+ * only have to look them up.
+ */
+void Map::preloadSprites()
+{
+	if (!Options::lazyLoadResources)
+	{
+		return;
+	}
+	Mod *mod = _game->getMod();
+	for (const char *name : { "CURSOR.PCK", "SMOKE.PCK", "Pathfinding", "HANDOB.PCK", "BREATH-1.PCK", "DETBLOB.DAT", "FLOOROB.PCK" })
+	{
+		mod->getSurfaceSet(name, false);
+	}
+	for (const auto* bu : *_save->getUnits())
+	{
+		mod->getSurfaceSet(bu->getArmor()->getSpriteSheet(), false);
+	}
+}
+
+/**
+ * Gets the part of the map surface covered by the selector
+ * at a given position, on all the levels it is shown on.
+ * @param selectorX X position of the selector on the map.
+ * @param selectorY Y position of the selector on the map.
+ * @return Screen area of the selector.
+ */
+SDL_Rect Map::getSelectorArea(int selectorX, int selectorY) const
+{
+	const Position offset = _camera->getMapOffset();
+	int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+	for (int z = 0; z <= _camera->getViewLevel(); ++z)
+	{
+		for (int x = selectorX; x < selectorX + _cursorSize; ++x)
+		{
+			for (int y = selectorY; y < selectorY + _cursorSize; ++y)
+			{
+				Position screenPosition;
+				_camera->convertMapToScreen(Position(x, y, z), &screenPosition);
+				screenPosition += offset;
+				left = std::min(left, (int)screenPosition.x);
+				top = std::min(top, (int)screenPosition.y);
+				right = std::max(right, screenPosition.x + std::max(_spriteWidth, _txtAccuracy->getWidth()));
+				bottom = std::max(bottom, screenPosition.y + std::max(_spriteHeight, _txtAccuracy->getHeight()));
+			}
+		}
+	}
+	left = Clamp(left, 0, getWidth());
+	top = Clamp(top, 0, getHeight());
+	right = Clamp(right, left, getWidth());
+	bottom = Clamp(bottom, top, getHeight());
+	return SDL_Rect{ (Sint16)left, (Sint16)top, (Uint16)(right - left), (Uint16)(bottom - top) };
 }
 
 /**
@@ -348,6 +900,9 @@ void Map::draw()
 void Map::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
+	_redraw = true;
+	delete _regionSurface;
+	_regionSurface = 0;
 	for (auto* mds : *_save->getMapDataSets())
 	{
 		mds->getSurfaceset()->setPalette(colors, firstcolor, ncolors);
@@ -436,6 +991,7 @@ int getShadePulseForFrame(int shade, int frame)
 /**
  * Draw part of unit graphic that overlap current tile.
  * @param surface
+ * @param camera
  * @param unitTile
  * @param currTile
  * @param currTileScreenPosition
@@ -443,7 +999,7 @@ int getShadePulseForFrame(int shade, int frame)
  * @param obstacleShade
  * @param topLayer
  */
-void Map::drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position currTileScreenPosition, bool topLayer, BattleUnit* movingUnit)
+void Map::drawUnit(UnitSprite &unitSprite, const Camera *camera, Tile *unitTile, Tile *currTile, Position currTileScreenPosition, bool topLayer, BattleUnit* movingUnit)
 {
 	const int tileFoorWidth = 32;
 	const int tileFoorHeight = 16;
@@ -633,8 +1189,8 @@ void Map::drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Posit
 	}
 
 	Position tileScreenPosition;
-	_camera->convertMapToScreen(unitTile->getPosition() + Position(0,0, (-unitFromBelow) + (+unitFromAbove)), &tileScreenPosition);
-	tileScreenPosition += _camera->getMapOffset();
+	camera->convertMapToScreen(unitTile->getPosition() + Position(0,0, (-unitFromBelow) + (+unitFromAbove)), &tileScreenPosition);
+	tileScreenPosition += camera->getMapOffset();
 
 	//get shade helpers
 	auto getTileShade = [&](Tile* tile)
@@ -690,10 +1246,10 @@ void Map::drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Posit
  * Draw the terrain.
  * Keep this function as optimised as possible. It's big to minimise overhead of function calls.
  * @param surface The surface to draw on.
+ * @param camera The camera to draw with, its offset places the surface on the map.
  */
-void Map::drawTerrain(Surface *surface)
+void Map::drawTerrain(Surface *surface, Camera *camera)
 {
-	_isAltPressed = _game->isAltPressed(true);
 	int frameNumber = 0;
 	SurfaceRaw<const Uint8> tmpSurface;
 	Tile *tile;
@@ -702,8 +1258,10 @@ void Map::drawTerrain(Surface *surface)
 	int beginZ = 0, endZ = _save->getMapSizeZ() - 1;
 	Position mapPosition, screenPosition, bulletPositionScreen, movingUnitPosition;
 	int bulletLowX=16000, bulletLowY=16000, bulletLowZ=16000, bulletHighX=0, bulletHighY=0, bulletHighZ=0;
-	int dummy;
-	BattleUnit *movingUnit = _save->getTileEngine()->getMovingUnit();
+	// the terrain layer leaves out everything that is not part of the terrain
+	const bool drawDynamic = !_drawingTerrainLayer;
+	const bool drawCursor = drawDynamic && _cursorType != CT_NONE;
+	BattleUnit *movingUnit = drawDynamic ? _save->getTileEngine()->getMovingUnit() : nullptr;
 	int tileShade, tileColor, obstacleShade;
 	UnitSprite unitSprite(surface, _game->getMod(), _save, _animFrame, _save->getDepth() != 0);
 	ItemSprite itemSprite(surface, _game->getMod(), _save, _animFrame);
@@ -741,18 +1299,18 @@ void Map::drawTerrain(Surface *surface)
 		bulletHighZ = bulletHighZ / 24;
 
 		// if the projectile is outside the viewport - center it back on it
-		_camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
+		camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
 
 		if (_projectileInFOV && _followProjectile)
 		{
-			Position newCam = _camera->getMapOffset();
+			Position newCam = camera->getMapOffset();
 			if (newCam.z != bulletHighZ) //switch level
 			{
 				newCam.z = bulletHighZ;
 				if (_projectileInFOV)
 				{
-					_camera->setMapOffset(newCam);
-					_camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
+					camera->setMapOffset(newCam);
+					camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
 				}
 			}
 			if (_smoothCamera)
@@ -763,8 +1321,8 @@ void Map::drawTerrain(Surface *surface)
 					if ((bulletPositionScreen.x < 1 || bulletPositionScreen.x > surface->getWidth() - 1 ||
 						bulletPositionScreen.y < 1 || bulletPositionScreen.y > _visibleMapHeight - 1))
 					{
-						_camera->centerOnPosition(Position(bulletLowX, bulletLowY, bulletHighZ), false);
-						_camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
+						camera->centerOnPosition(Position(bulletLowX, bulletLowY, bulletHighZ), false);
+						camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
 					}
 				}
 				if (!_smoothingEngaged)
@@ -777,7 +1335,7 @@ void Map::drawTerrain(Surface *surface)
 				}
 				else
 				{
-					_camera->jumpXY(surface->getWidth() / 2 - bulletPositionScreen.x, _visibleMapHeight / 2 - bulletPositionScreen.y);
+					camera->jumpXY(surface->getWidth() / 2 - bulletPositionScreen.x, _visibleMapHeight / 2 - bulletPositionScreen.y);
 				}
 			}
 			else
@@ -788,47 +1346,32 @@ void Map::drawTerrain(Surface *surface)
 					enough = true;
 					if (bulletPositionScreen.x < 0)
 					{
-						_camera->jumpXY(+surface->getWidth(), 0);
+						camera->jumpXY(+surface->getWidth(), 0);
 						enough = false;
 					}
 					else if (bulletPositionScreen.x > surface->getWidth())
 					{
-						_camera->jumpXY(-surface->getWidth(), 0);
+						camera->jumpXY(-surface->getWidth(), 0);
 						enough = false;
 					}
 					else if (bulletPositionScreen.y < 0)
 					{
-						_camera->jumpXY(0, +_visibleMapHeight);
+						camera->jumpXY(0, +_visibleMapHeight);
 						enough = false;
 					}
 					else if (bulletPositionScreen.y > _visibleMapHeight)
 					{
-						_camera->jumpXY(0, -_visibleMapHeight);
+						camera->jumpXY(0, -_visibleMapHeight);
 						enough = false;
 					}
-					_camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
+					camera->convertVoxelToScreen(_projectile->getPosition(), &bulletPositionScreen);
 				}
 				while (!enough);
 			}
 		}
 	}
 
-	// get corner map coordinates to give rough boundaries in which tiles to redraw are
-	_camera->convertScreenToMap(0, 0, &beginX, &dummy);
-	_camera->convertScreenToMap(surface->getWidth(), 0, &dummy, &beginY);
-	_camera->convertScreenToMap(surface->getWidth() + _spriteWidth, surface->getHeight() + _spriteHeight, &endX, &dummy);
-	_camera->convertScreenToMap(0, surface->getHeight() + _spriteHeight, &dummy, &endY);
-	beginY -= (_camera->getViewLevel() * 2);
-	beginX -= (_camera->getViewLevel() * 2);
-	if (beginX < 0)
-		beginX = 0;
-	if (beginY < 0)
-		beginY = 0;
-
-	if (!_camera->getShowAllLayers())
-	{
-		endZ = std::min(endZ, _camera->getViewLevel());
-	}
+	getTerrainBounds(surface, camera, beginX, endX, beginY, endY, endZ);
 
 
 	bool pathfinderTurnedOn = _save->getPathfinding()->isPathPreviewed();
@@ -845,8 +1388,12 @@ void Map::drawTerrain(Surface *surface)
 		movingUnitPosition = movingUnit->getPosition();
 	}
 
+	if (!_shadeCacheShared)
+	{
+		prepareShadeCache();
+	}
 	surface->lock();
-	const auto cameraPos = _camera->getMapOffset();
+	const auto cameraPos = camera->getMapOffset();
 	for (int itZ = beginZ; itZ <= endZ; itZ++)
 	{
 		bool topLayer = itZ == endZ;
@@ -856,7 +1403,7 @@ void Map::drawTerrain(Surface *surface)
 			tile = _save->getTile(mapPosition);
 			for (int itX = beginX; itX < endX; itX++, mapPosition.x++, tile++)
 			{
-				_camera->convertMapToScreen(mapPosition, &screenPosition);
+				camera->convertMapToScreen(mapPosition, &screenPosition);
 				screenPosition += cameraPos;
 
 				// only render cells that are inside the surface
@@ -898,9 +1445,9 @@ void Map::drawTerrain(Surface *surface)
 					auto unit = tile->getUnit();
 
 					// Draw cursor back
-					if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && !_save->getBattleState()->getMouseOverIcons())
+					if (drawCursor && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && !_save->getBattleState()->getMouseOverIcons())
 					{
-						if (_camera->getViewLevel() == itZ)
+						if (camera->getViewLevel() == itZ)
 						{
 							if (_cursorType != CT_AIM)
 							{
@@ -919,7 +1466,7 @@ void Map::drawTerrain(Surface *surface)
 							tmpSurface = _game->getMod()->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
 							Surface::blitRaw(surface, tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
-						else if (_camera->getViewLevel() > itZ)
+						else if (camera->getViewLevel() > itZ)
 						{
 							frameNumber = 2; // blue box
 							tmpSurface = _game->getMod()->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
@@ -939,7 +1486,7 @@ void Map::drawTerrain(Surface *surface)
 
 						for (size_t b = 0; b < std::size(backPos); ++b)
 						{
-							drawUnit(unitSprite, _save->getTile(mapPosition + backPos[b]), tile, screenPosition, topLayer);
+							drawUnit(unitSprite, camera, _save->getTile(mapPosition + backPos[b]), tile, screenPosition, topLayer);
 						}
 					}
 
@@ -978,7 +1525,7 @@ void Map::drawTerrain(Surface *surface)
 							}
 						}
 						// draw an item on top of the floor (if any)
-						BattleItem* item = tile->getTopItem();
+						BattleItem* item = drawDynamic ? tile->getTopItem() : nullptr;
 						if (item)
 						{
 							itemSprite.draw(item,
@@ -1041,7 +1588,7 @@ void Map::drawTerrain(Surface *surface)
 								voxelPos.z / 24 == itZ &&
 								_save->getTileEngine()->isVoxelVisible(voxelPos))
 							{
-								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+								camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 
 								itemSprite.drawShadow(item,
 									bulletPositionScreen.x - 16,
@@ -1058,7 +1605,7 @@ void Map::drawTerrain(Surface *surface)
 								voxelPos.z / 24 == itZ &&
 								_save->getTileEngine()->isVoxelVisible(voxelPos))
 							{
-								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+								camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 
 								itemSprite.draw(item,
 									bulletPositionScreen.x - 16,
@@ -1095,7 +1642,7 @@ void Map::drawTerrain(Surface *surface)
 											voxelPos.z / 24 == itZ &&
 											_save->getTileEngine()->isVoxelVisible(voxelPos))
 										{
-											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+											camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 											bulletPositionScreen.x -= tmpSurface.getWidth() / 2;
 											bulletPositionScreen.y -= tmpSurface.getHeight() / 2;
 											Surface::blitRaw(surface, tmpSurface, bulletPositionScreen.x, bulletPositionScreen.y, 16, false, _nvColor);
@@ -1108,7 +1655,7 @@ void Map::drawTerrain(Surface *surface)
 											voxelPos.z / 24 == itZ &&
 											_save->getTileEngine()->isVoxelVisible(voxelPos))
 										{
-											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
+											camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 											bulletPositionScreen.x -= tmpSurface.getWidth() / 2;
 											bulletPositionScreen.y -= tmpSurface.getHeight() / 2;
 											Surface::blitRaw(surface, tmpSurface, bulletPositionScreen.x, bulletPositionScreen.y, 0, false, _nvColor);
@@ -1150,7 +1697,10 @@ void Map::drawTerrain(Surface *surface)
 
 					unit = tile->getUnit();
 					// Draw soldier from this tile, below or above
-					drawUnit(unitSprite, tile, tile, screenPosition, topLayer, isUnitMovingNearby ? movingUnit : nullptr);
+					if (drawDynamic)
+					{
+						drawUnit(unitSprite, camera, tile, tile, screenPosition, topLayer, isUnitMovingNearby ? movingUnit : nullptr);
+					}
 
 					if (isUnitMovingNearby)
 					{
@@ -1166,12 +1716,12 @@ void Map::drawTerrain(Surface *surface)
 
 						for (size_t f = 0; f < std::size(frontPos); ++f)
 						{
-							drawUnit(unitSprite, _save->getTile(mapPosition + frontPos[f]), tile, screenPosition, topLayer);
+							drawUnit(unitSprite, camera, _save->getTile(mapPosition + frontPos[f]), tile, screenPosition, topLayer);
 						}
 					}
 
 					// Draw smoke/fire
-					if (tile->getSmoke() && tile->isDiscovered(O_FLOOR))
+					if (drawDynamic && tile->getSmoke() && tile->isDiscovered(O_FLOOR))
 					{
 						frameNumber = 0;
 						int shade = 0;
@@ -1256,9 +1806,11 @@ void Map::drawTerrain(Surface *surface)
 						}
 					}
 					// Draw cursor front
-					if (_cursorType != CT_NONE && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && !_save->getBattleState()->getMouseOverIcons())
+					if (drawCursor && _selectorX > itX - _cursorSize && _selectorY > itY - _cursorSize && _selectorX < itX+1 && _selectorY < itY+1 && !_save->getBattleState()->getMouseOverIcons())
 					{
-						if (_camera->getViewLevel() == itZ)
+						// the accuracy text and its cached values are shared by all strips drawn in parallel
+						std::lock_guard<std::mutex> lock(_cursorMutex);
+						if (camera->getViewLevel() == itZ)
 						{
 							if (_cursorType != CT_AIM)
 							{
@@ -1557,13 +2109,13 @@ void Map::drawTerrain(Surface *surface)
 								_txtAccuracy->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
 							}
 						}
-						else if (_camera->getViewLevel() > itZ)
+						else if (camera->getViewLevel() > itZ)
 						{
 							frameNumber = 5; // blue box
 							tmpSurface = _game->getMod()->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
 							Surface::blitRaw(surface, tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
-						if (!_isAltPressed && _cursorType > CT_AIM && _camera->getViewLevel() == itZ)
+						if (!_isAltPressed && _cursorType > CT_AIM && camera->getViewLevel() == itZ)
 						{
 							bool ignore = false;
 							if (_cursorType == CT_PSI || _cursorType == CT_WAYPOINT)
@@ -1636,8 +2188,8 @@ void Map::drawTerrain(Surface *surface)
 				for (int itY = beginY; itY <= endY; itY++)
 				{
 					mapPosition = Position(itX, itY, itZ);
-					_camera->convertMapToScreen(mapPosition, &screenPosition);
-					screenPosition += _camera->getMapOffset();
+					camera->convertMapToScreen(mapPosition, &screenPosition);
+					screenPosition += camera->getMapOffset();
 
 					// only render cells that are inside the surface
 					if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
@@ -1720,10 +2272,10 @@ void Map::drawTerrain(Surface *surface)
 	}
 
 	auto selectedUnit = _save->getSelectedUnit();
-	if (selectedUnit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && selectedUnit->getPosition().z <= _camera->getViewLevel())
+	if (selectedUnit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && selectedUnit->getPosition().z <= camera->getViewLevel())
 	{
-		_camera->convertMapToScreen(selectedUnit->getPosition(), &screenPosition);
-		screenPosition += _camera->getMapOffset();
+		camera->convertMapToScreen(selectedUnit->getPosition(), &screenPosition);
+		screenPosition += camera->getMapOffset();
 		Position offset = calculateWalkingOffset(selectedUnit).ScreenOffset;
 		if (selectedUnit->isBigUnit())
 		{
@@ -1734,7 +2286,7 @@ void Map::drawTerrain(Surface *surface)
 		{
 			offset.y -= 2;
 		}
-		if (this->getCursorType() != CT_NONE)
+		if (drawCursor)
 		{
 			_arrow->blitNShade(surface, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + getArrowBobForFrame(_animFrame), 0);
 		}
@@ -1748,9 +2300,9 @@ void Map::drawTerrain(Surface *surface)
 			if (myUnit->getScannedTurn() == _save->getTurn() && myUnit->getFaction() != FACTION_PLAYER && !myUnit->isOut())
 			{
 				Position temp = myUnit->getPosition();
-				temp.z = _camera->getViewLevel();
-				_camera->convertMapToScreen(temp, &screenPosition);
-				screenPosition += _camera->getMapOffset();
+				temp.z = camera->getViewLevel();
+				camera->convertMapToScreen(temp, &screenPosition);
+				screenPosition += camera->getMapOffset();
 				Position offset;
 				//calculateWalkingOffset(myUnit, &offset);
 				if (myUnit->isBigUnit())
@@ -1777,10 +2329,10 @@ void Map::drawTerrain(Surface *surface)
 	{
 		for (auto& pos : _save->getCraftTiles())
 		{
-			if (pos.z == _camera->getViewLevel())
+			if (pos.z == camera->getViewLevel())
 			{
-				_camera->convertMapToScreen(pos, &screenPosition);
-				screenPosition += _camera->getMapOffset();
+				camera->convertMapToScreen(pos, &screenPosition);
+				screenPosition += camera->getMapOffset();
 				screenPosition.y += 2; // based on vanilla soldier standHeight
 				_arrow->blitNShade(
 					surface,
@@ -1815,7 +2367,7 @@ void Map::drawTerrain(Surface *surface)
 		{
 			for (const auto* explosion : _explosions)
 			{
-				_camera->convertVoxelToScreen(explosion->getPosition(), &bulletPositionScreen);
+				camera->convertVoxelToScreen(explosion->getPosition(), &bulletPositionScreen);
 				if (explosion->isBig())
 				{
 					if (explosion->getCurrentFrame() >= 0)
@@ -1839,6 +2391,72 @@ void Map::drawTerrain(Surface *surface)
 	}
 
 	surface->unlock();
+	if (!_shadeCacheShared)
+	{
+		_shadeCacheActive = false;
+	}
+}
+
+/**
+ * Gets the rough boundaries of the tiles that can show up on a surface.
+ * @param surface The surface to draw on.
+ * @param camera The camera to draw with.
+ * @param beginX Returns the first tile column.
+ * @param endX Returns the last tile column.
+ * @param beginY Returns the first tile row.
+ * @param endY Returns the last tile row.
+ * @param endZ Returns the highest level.
+ */
+void Map::getTerrainBounds(const Surface *surface, const Camera *camera, int &beginX, int &endX, int &beginY, int &endY, int &endZ) const
+{
+	int dummy;
+	// get corner map coordinates to give rough boundaries in which tiles to redraw are
+	camera->convertScreenToMap(0, 0, &beginX, &dummy);
+	camera->convertScreenToMap(surface->getWidth(), 0, &dummy, &beginY);
+	camera->convertScreenToMap(surface->getWidth() + _spriteWidth, surface->getHeight() + _spriteHeight, &endX, &dummy);
+	camera->convertScreenToMap(0, surface->getHeight() + _spriteHeight, &dummy, &endY);
+	beginY -= (camera->getViewLevel() * 2);
+	beginX -= (camera->getViewLevel() * 2);
+	if (beginX < 0)
+		beginX = 0;
+	if (beginY < 0)
+		beginY = 0;
+
+	endZ = _save->getMapSizeZ() - 1;
+	if (!camera->getShowAllLayers())
+	{
+		endZ = std::min(endZ, camera->getViewLevel());
+	}
+}
+
+/**
+ * Starts caching tile shades for one pass of drawTerrain, as each
+ * tile shade is needed several times (floor, walls, units) and
+ * night vision checks the distance to every player unit.
+ * Lighting, units and fading don't change during a pass.
+ */
+void Map::prepareShadeCache()
+{
+	size_t size = _save->getMapSizeXYZ();
+	if (_shadeCacheStamps.size() != size || ++_shadeCacheStamp == 0)
+	{
+		_shadeCacheStamps.assign(size, 0);
+		_shadeCache.assign(size, 0);
+		_shadeCacheStamp = 1;
+	}
+
+	_nightVisionUnits.clear();
+	if (_nvColor != 0 && _debugVisionMode <= 0)
+	{
+		for (const auto* bu : *_save->getUnits())
+		{
+			if (bu->getFaction() == FACTION_PLAYER && !bu->isOut())
+			{
+				_nightVisionUnits.push_back(std::make_pair(bu->getPosition(), bu->getMaxViewDistanceAtDarkSquared()));
+			}
+		}
+	}
+	_shadeCacheActive = true;
 }
 
 /**
@@ -1883,6 +2501,7 @@ void Map::enableNightVision()
 	_nightVisionOn = true;
 	_debugVisionMode = 0;
 	persistToggles();
+	invalidate();
 }
 
 void Map::toggleNightVision()
@@ -1890,6 +2509,7 @@ void Map::toggleNightVision()
 	_nightVisionOn = !_nightVisionOn;
 	_debugVisionMode = 0;
 	persistToggles();
+	invalidate();
 }
 
 void Map::toggleDebugVisionMode()
@@ -1897,6 +2517,7 @@ void Map::toggleDebugVisionMode()
 	_debugVisionMode = (_debugVisionMode + 1) % 3;
 	_nightVisionOn = false;
 	persistToggles();
+	invalidate();
 }
 
 void Map::persistToggles()
@@ -1930,6 +2551,31 @@ void Map::persistToggles()
  */
 
 int Map::reShade(Tile *tile)
+{
+	if (_shadeCacheActive)
+	{
+		int index = _save->getTileIndex(tile->getPosition());
+		if (_shadeCacheStamps[index] != _shadeCacheStamp)
+		{
+			if (_shadeCacheShared)
+			{
+				// filled up front and only read while strips are drawn in parallel
+				return calculateShade(tile);
+			}
+			_shadeCacheStamps[index] = _shadeCacheStamp;
+			_shadeCache[index] = calculateShade(tile);
+		}
+		return _shadeCache[index];
+	}
+	return calculateShade(tile);
+}
+
+/**
+ * Calculates the shade of a tile, with night vision and fading applied.
+ * @param tile Tile to shade.
+ * @return Shade of the tile.
+ */
+int Map::calculateShade(Tile *tile)
 {
 	// when modders just don't know where to stop...
 	if (_debugVisionMode > 0)
@@ -1956,16 +2602,29 @@ int Map::reShade(Tile *tile)
 	}
 
 	// hybrid night vision (local)
-	for (const auto* bu : *_save->getUnits())
+	if (_shadeCacheActive)
 	{
-		if (bu->getFaction() == FACTION_PLAYER && !bu->isOut())
+		for (const auto& nv : _nightVisionUnits)
 		{
-			if (Position::distance2dSq(tile->getPosition(), bu->getPosition()) <= bu->getMaxViewDistanceAtDarkSquared())
+			if (Position::distance2dSq(tile->getPosition(), nv.first) <= nv.second)
 			{
 				return tile->getShade() > _fadeShade ? _fadeShade : tile->getShade();
 			}
 		}
 	}
+	else
+	{
+		for (const auto* bu : *_save->getUnits())
+		{
+			if (bu->getFaction() == FACTION_PLAYER && !bu->isOut())
+			{
+				if (Position::distance2dSq(tile->getPosition(), bu->getPosition()) <= bu->getMaxViewDistanceAtDarkSquared())
+				{
+					return tile->getShade() > _fadeShade ? _fadeShade : tile->getShade();
+				}
+			}
+		}
+	}
 
 	// hybrid night vision (global)
 	return std::min(+NIGHT_VISION_MAX_SHADE, tile->getShade());
@@ -2010,7 +2669,7 @@ void Map::setSelectorPosition(int mx, int my)
 
 	if (oldX != _selectorX || oldY != _selectorY)
 	{
-		_redraw = true;
+		_partialRedraw = true;
 	}
 }
 
@@ -2036,10 +2695,31 @@ void Map::animate(bool redraw)
 		}
 	}
 
-	// animate tiles
+	// animate tiles, noting the ones whose sprites changed
+	++_animTicksSinceDraw;
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		_save->getTile(i)->animate();
+		Tile *tile = _save->getTile(i);
+		const Uint8 *sprites[O_MAX];
+		for (int part = O_FLOOR; part < O_MAX; ++part)
+		{
+			sprites[part] = tile->getSprite((TilePart)part).getBuffer();
+		}
+		tile->animate();
+		for (int part = O_FLOOR; part < O_MAX; ++part)
+		{
+			if (sprites[part] != tile->getSprite((TilePart)part).getBuffer())
+			{
+				_animatedTiles.push_back(tile->getPosition());
+				if (!_terrainLayerStale[i])
+				{
+					// the terrain layer still shows the old sprite
+					_terrainLayerStale[i] = true;
+					_terrainLayerStaleTiles.push_back(tile->getPosition());
+				}
+				break;
+			}
+		}
 	}
 
 	// animate vapor
@@ -2138,7 +2818,7 @@ void Map::animate(bool redraw)
 		bu->breathe();
 	}
 
-	if (redraw) _redraw = true;
+	if (redraw) _partialRedraw = true;
 }
 
 /**
@@ -2415,6 +3095,7 @@ void Map::scrollKey()
  */
 void Map::fadeShade()
 {
+	const int oldShade = _fadeShade, oldColor = _nvColor;
 	bool hold = SDL_GetKeyState(NULL)[Options::keyNightVisionHold];
 	if ((_nightVisionOn && !hold) || (!_nightVisionOn && hold))
 	{
@@ -2440,6 +3121,11 @@ void Map::fadeShade()
 			}
 		}
 	}
+	if (_fadeShade != oldShade || _nvColor != oldColor)
+	{
+		// the whole map is shaded differently
+		invalidate();
+	}
 }
 
 /**
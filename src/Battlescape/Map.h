@@ -23,6 +23,7 @@
 #include "Position.h"
 #include "Particle.h"
 #include <vector>
+#include <mutex>
 
 namespace OpenXcom
 {
@@ -39,6 +40,7 @@ class Timer;
 class Text;
 class Tile;
 class UnitSprite;
+class ThreadPool;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
 enum TilePart : int;
@@ -103,13 +105,53 @@ private:
 	Text *_txtAccuracy;
 	SurfaceSet *_projectileSet;
 
-	void drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
-	void drawTerrain(Surface *surface);
+	void drawUnit(UnitSprite &unitSprite, const Camera *camera, Tile *unitTile, Tile *currTile, Position tileScreenPosition, bool topLayer, BattleUnit* movingUnit = nullptr);
+	void drawTerrain(Surface *surface, Camera *camera);
+	void getTerrainBounds(const Surface *surface, const Camera *camera, int &beginX, int &endX, int &beginY, int &endY, int &endZ) const;
 	int getTerrainLevel(const Position& pos, int size) const;
 	int getWallShade(TilePart part, Tile* tileFrot);
 	int _iconHeight, _iconWidth, _messageColor;
 	const std::vector<Uint8> *_transparencies;
 	bool _showObstacles;
+	bool _partialRedraw, _lastFrameValid, _lastFrameAlt, _lastFrameOverIcons, _lastFrameAllLayers;
+	Position _lastFrameOffset;
+	int _lastFrameSelectorX, _lastFrameSelectorY, _lastFrameAnimFrame, _lastFrameCursorSize;
+	CursorType _lastFrameCursorType;
+	Uint32 _lastFrameTileChanges;
+	BattleUnit *_lastFrameSelectedUnit;
+	size_t _lastFrameWaypoints;
+	int _animTicksSinceDraw;
+	std::vector<Position> _animatedTiles;
+	Surface *_regionSurface;
+	Surface *_terrainLayer;
+	bool _drawingTerrainLayer, _terrainLayerAllLayers;
+	Position _terrainLayerOffset;
+	Uint32 _terrainLayerTileChanges;
+	int _terrainLayerFadeShade, _terrainLayerNvColor, _terrainLayerDebugVisionMode;
+	bool _terrainLayerDebugMode;
+	std::vector<bool> _terrainLayerStale;
+	std::vector<Position> _terrainLayerStaleTiles;
+	bool _shadeCacheActive, _shadeCacheShared;
+	Uint32 _shadeCacheStamp;
+	std::vector<Uint32> _shadeCacheStamps;
+	std::vector<Sint8> _shadeCache;
+	std::vector<std::pair<Position, int> > _nightVisionUnits;
+	ThreadPool *_renderPool;
+	std::mutex _cursorMutex;
+
+	void fillBackground(Surface *surface);
+	bool drawChanged();
+	bool addAnimatedAreas(std::vector<SDL_Rect> &areas) const;
+	void addTileAreas(std::vector<SDL_Rect> &areas, std::vector<Position> tiles) const;
+	bool hasVaporParticles() const;
+	bool areAreasCheap(const std::vector<SDL_Rect> &areas) const;
+	bool drawLayered();
+	void drawRegion(const SDL_Rect &area);
+	bool drawStrips();
+	void preloadSprites();
+	SDL_Rect getSelectorArea(int selectorX, int selectorY) const;
+	void prepareShadeCache();
+	int calculateShade(Tile *tile);
 public:
 	/// Creates a new map at the specified position and size.
 	Map(Game* game, int width, int height, int x, int y, int visibleMapHeight);
@@ -121,6 +163,12 @@ public:
 	void think() override;
 	/// Draws the surface.
 	void draw() override;
+	/// Blits the surface onto another one.
+	void blit(SDL_Surface *surface) override;
+	/// Checks if the map will be redrawn on the next blit.
+	bool isRedrawPending() const override { return _redraw || _partialRedraw; }
+	/// Redraws the map after a camera pan.
+	void invalidateScroll();
 	/// Sets the palette.
 	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256) override;
 	void refreshHiddenMovementBackground();
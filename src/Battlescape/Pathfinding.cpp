@@ -27,6 +27,7 @@
 #include "../Engine/Options.h"
 #include "../fmath.h"
 #include "BattlescapeGame.h"
+#include "BattleReplay.h"
 
 namespace OpenXcom
 {
@@ -99,6 +100,7 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleAction
  */
 void Pathfinding::calculate(BattleUnit *unit, Position startPosition, Position endPosition, BattleActionMove bam, const BattleUnit *missileTarget, int maxTUCost)
 {
+	BattleReplayScope replayScope(REPLAY_PATHFINDING);
 	_totalTUCost = {};
 	_path.clear();
 
@@ -1479,6 +1481,7 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, const BattleAction
  */
 std::vector<PathfindingNode*> Pathfinding::findReachablePathFindingNodes(BattleUnit* unit, const BattleActionCost& cost, bool& ranOutOfTUs, bool entireMap, const BattleUnit* missileTarget, const Position* alternateStart, bool justCheckIfAnyMovementIsPossible, bool useMaxTUs, BattleActionMove bam)
 {
+	BattleReplayScope replayScope(REPLAY_PATHFINDING);
 	_unit = unit;
 	Position start = unit->getPosition();
 	if (alternateStart)
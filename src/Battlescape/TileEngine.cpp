@@ -42,6 +42,7 @@
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
+#include "BattleReplay.h"
 
 namespace OpenXcom
 {
@@ -1385,6 +1386,7 @@ inline bool TileEngine::inEventVisibilitySector(const Position &toCheck) const
 */
 bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
 {
+	BattleReplayScope replayScope(REPLAY_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	bool useTurretDirection = false;
 	if (Options::strafe && (unit->getTurretType() > -1)) {
@@ -1485,6 +1487,7 @@ bool TileEngine::calculateUnitsInFOV(BattleUnit* unit, const Position eventPos,
 */
 void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos, const int eventRadius)
 {
+	BattleReplayScope replayScope(REPLAY_FOV);
 	bool useTurretDirection = false;
 	bool skipNarrowArcTest = false;
 	int direction;
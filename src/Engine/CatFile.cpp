@@ -20,7 +20,6 @@
 #include "CatFile.h"
 #include "Logger.h"
 #include "FileMap.h"
-#include "SDL2Helpers.h"
 
 namespace OpenXcom
 {
@@ -31,7 +30,7 @@ namespace OpenXcom
  * of a filename followed by its contents.
  * @param rw SDL_RWops of the CAT file.
  */
-CatFile::CatFile(const std::string& filename) : _data(0), _items()
+CatFile::CatFile(const std::string& filename) : _items()
 {
 	// Get amount of files
 
@@ -61,33 +60,31 @@ CatFile::CatFile(const std::string& filename) : _data(0), _items()
 	 * 		SOUND/SAMPLE2.CAT
 	 *		TFTD/SOUND/SAMPLE.CAT
 	 *
-	 * Given an rwops object, this reads it and sets up rwops instances
-	 * for each chunk.
-	 *
-	 * The original rwops object is consumed here.
+	 * Given a view of the file, this reads the index and sets up rwops instances
+	 * for each chunk directly over the (usually memory mapped) file data.
 	 */
 	_filename = filename;
-	auto rwops = FileMap::getRWops(filename);
-	auto offset0 = SDL_ReadLE32(rwops); // read the first offset; 8 is the sizeof(item) of the header
-	SDL_RWseek(rwops, 0, RW_SEEK_SET);  // reset the rwops pointer back
-	size_t filesize;
-	_data = (Uint8 *)SDL_LoadFile_RW(rwops, &filesize, SDL_FALSE); // read all of the file
-	SDL_RWseek(rwops, 0, RW_SEEK_SET);  // and again reset the rwops pointer back
+	_data = FileMap::getView(filename);
+	const Uint8 *data = _data->data();
+	size_t filesize = _data->size();
+	auto readLE32 = [&](size_t pos) -> Uint32
+	{
+		return data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16) | ((Uint32)data[pos + 3] << 24);
+	};
 
+	auto offset0 = filesize >= 4 ? readLE32(0) : 0; // read the first offset; 8 is the sizeof(item) of the header
 	if (offset0 >= filesize) {
 		Log(LOG_WARNING) << "Catfile(" << filename << "): first offset " << offset0 << ">= file size " << filesize << ", not parsing.";
-		SDL_RWclose(rwops);
 		return;
 	}
 	for (Uint32 i = 0; i < offset0 / 8; ++i) {
-		auto offset = SDL_ReadLE32(rwops);
-		SDL_ReadLE32(rwops); // ignore size;
+		auto offset = readLE32(i * 8); // size at i * 8 + 4 is ignored
 		// reject bad data
 		if (offset >= filesize) {
 			Log(LOG_WARNING) << "Catfile("<<filename<<"): item "<<i<<" outside of the file: offset="<<offset<<" "<<" filesize="<<filesize;
 			continue;
 		}
-		_items.push_back(std::make_tuple(_data + offset, offset));
+		_items.push_back(std::make_tuple(data + offset, offset));
 	}
 	Uint32 last_offset = filesize;
 	for ( auto it = _items.rbegin(); it != _items.rend(); ++it) {
@@ -95,7 +92,6 @@ CatFile::CatFile(const std::string& filename) : _data(0), _items()
 		std::get<1>(*it) = last_offset - this_offset;
 		last_offset = this_offset;
 	}
-	SDL_RWclose(rwops);
 }
 
 /**
@@ -103,7 +99,7 @@ CatFile::CatFile(const std::string& filename) : _data(0), _items()
  */
 CatFile::~CatFile()
 {
-	if (_data) { SDL_free(_data); }
+
 }
 
 /**
@@ -20,7 +20,9 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <memory>
 #include <SDL_rwops.h>
+#include "FileMap.h"
 
 
 namespace OpenXcom
@@ -33,8 +35,8 @@ class CatFile
 {
 private:
 	std::string _filename;
-	Uint8 *_data;
-	std::vector<std::tuple<void *, size_t>> _items;
+	std::unique_ptr<FileMap::FileView> _data;
+	std::vector<std::tuple<const Uint8 *, size_t>> _items;
 
 public:
 	/// Creates a CAT file stream.
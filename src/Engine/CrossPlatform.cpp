@@ -79,6 +79,10 @@
 #include <cxxabi.h>
 #include <dlfcn.h>
 #include <dirent.h>
+#ifndef __MORPHOS__
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
 #include "Unicode.h"
 #endif		/* #ifdef _WIN32 */
 #include <SDL.h>
@@ -694,6 +698,29 @@ bool deleteFile(const std::string &path)
 #endif
 }
 
+/**
+ * Deletes a folder together with the files in it.
+ * @note Subfolders are not deleted, so the folder must not have any.
+ * @param path Full path to the folder.
+ * @return True if the folder was deleted.
+ */
+bool deleteFolder(const std::string &path)
+{
+	for (const auto& file : getFolderContents(path))
+	{
+		if (!std::get<1>(file))
+		{
+			deleteFile(path + "/" + std::get<0>(file));
+		}
+	}
+#ifdef _WIN32
+	auto pathW = pathToWindows(path);
+	return (RemoveDirectoryW(pathW.c_str()) != 0);
+#else
+	return (rmdir(path.c_str()) == 0);
+#endif
+}
+
 /**
  * Returns only the filename from a specified path.
  * @param path Full path.
@@ -876,7 +903,8 @@ time_t getDateModified(const std::string &path)
 #ifdef _WIN32
 	time_t rv = 0;
 	auto pathW = pathToWindows(path);
-	auto fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	// backup semantics allow opening directories as well
+	auto fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
 	if (fh == INVALID_HANDLE_VALUE) {
 		return 0;
 	}
@@ -967,6 +995,25 @@ bool moveFile(const std::string &src, const std::string &dest)
 #endif
 }
 
+/**
+ * Renames a file inside a folder, replacing any existing file.
+ * Unlike moveFile(), the destination is either the old file or
+ * the complete new one, never a partial copy.
+ * @param src Source path.
+ * @param dest Destination path, in the same folder.
+ * @return True if the operation succeeded, False otherwise.
+ */
+bool renameFile(const std::string &src, const std::string &dest)
+{
+#ifdef _WIN32
+	auto srcW = pathToWindows(src);
+	auto dstW = pathToWindows(dest);
+	return (MoveFileExW(srcW.c_str(), dstW.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+	return (rename(src.c_str(), dest.c_str()) == 0);
+#endif
+}
+
 /**
  * Copies a file from one path to another,
  * replacing any existing file.
@@ -1100,6 +1147,77 @@ std::unique_ptr<std::istream> getYamlSaveHeader(const std::string& filename) {
 	return std::unique_ptr<std::istream>(new std::istringstream(datastr));
 }
 
+/**
+ * Maps the whole content of a file read-only into memory.
+ * @param filename - what to map
+ * @param size - set to size of the file
+ * @return pointer to file data, or nullptr if the file can't be mapped.
+ */
+const void *mapFile(const std::string& filename, size_t &size) {
+	size = 0;
+#ifdef _WIN32
+	auto pathW = pathToWindows(filename);
+	auto fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fh == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fh, &fileSize) || fileSize.QuadPart <= 0 || (ULONGLONG)fileSize.QuadPart > (ULONGLONG)SIZE_MAX) {
+		CloseHandle(fh);
+		return nullptr;
+	}
+	auto mh = CreateFileMappingW(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fh);
+	if (mh == NULL) {
+		return nullptr;
+	}
+	const void *data = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mh); // the view keeps the mapping alive
+	if (data == NULL) {
+		return nullptr;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return data;
+#elif __MORPHOS__
+	return nullptr;
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0) {
+		close(fd);
+		return nullptr;
+	}
+	void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); // the mapping stays valid
+	if (data == MAP_FAILED) {
+		return nullptr;
+	}
+	size = (size_t)info.st_size;
+	return data;
+#endif
+}
+
+/**
+ * Releases memory mapped by mapFile().
+ * @param data - pointer returned by mapFile()
+ * @param size - size returned by mapFile()
+ */
+void unmapFile(const void *data, size_t size) {
+	if (!data) {
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+#elif __MORPHOS__
+	// nothing was mapped
+#else
+	munmap(const_cast<void *>(data), size);
+#endif
+}
+
 /**
  * Notifies the user that maybe he should have a look.
  */
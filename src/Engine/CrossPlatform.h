@@ -67,6 +67,8 @@ namespace CrossPlatform
 	bool fileExists(const std::string &path);
 	/// Deletes the specified file.
 	bool deleteFile(const std::string &path);
+	/// Deletes a folder and the files in it.
+	bool deleteFolder(const std::string &path);
 	/// Gets the pathless filename of a file.
 	std::string baseFilename(const std::string &path);
 	/// Sanitizes the characters in a filename.
@@ -87,6 +89,8 @@ namespace CrossPlatform
 	std::pair<std::string, std::string> timeToString(time_t time);
 	/// Move/rename a file between paths.
 	bool moveFile(const std::string &src, const std::string &dest);
+	/// Atomically renames a file inside a folder.
+	bool renameFile(const std::string &src, const std::string &dest);
 	/// Copy a file between paths.
 	bool copyFile(const std::string &src, const std::string &dest);
 	/// Writes out a file
@@ -94,6 +98,10 @@ namespace CrossPlatform
 	bool writeFile(const std::string& filename, const std::vector<unsigned char>& data);
 	/// Reads in a file
 	std::unique_ptr<std::istream> readFile(const std::string& filename);
+	/// Maps a file read-only into memory.
+	const void *mapFile(const std::string& filename, size_t &size);
+	/// Releases a file mapped into memory.
+	void unmapFile(const void *data, size_t size);
 	/// Reads file until "\n---" sequence is met or to the end. To be used only for savegames.
 	std::unique_ptr<std::istream> getYamlSaveHeader (const std::string& filename);
 	/// Flashes the game window.
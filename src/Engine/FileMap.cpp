@@ -36,6 +36,7 @@
  * A. somename.zip is always scanned before somename/ directory.
  */
 
+#include <ctime>
 #include <string>
 #include <sstream>
 #include <istream>
@@ -48,6 +49,8 @@
 #include "CrossPlatform.h"
 #include "Options.h"
 #include "Exception.h"
+#include "Profiler.h"
+#include "../md5.h"
 
 #define MINIZ_NO_STDIO
 #include "../../libs/miniz/miniz.h"
@@ -205,15 +208,145 @@ static inline std::string concatOptionalPaths(const std::string& basePath, const
 	}
 }
 
-FileRecord::FileRecord() : fullpath(""), zip(NULL), findex(0) { }
+/**
+ * Warps an existing file mapping in RWops, the mapping is released on close.
+ * @param data - mapped data, can be NULL
+ * @param size - size of the mapping
+ * @return RWops or NULL if there is no mapping.
+ */
+static SDL_RWops *SDL_RWFromMapping(const void *data, size_t size)
+{
+	if (!data) { return NULL; }
+	SDL_RWops *rv = SDL_RWFromConstMem(data, size);
+	if (!rv)
+	{
+		CrossPlatform::unmapFile(data, size);
+		return NULL;
+	}
+
+	//close callback
+	rv->close = [](struct SDL_RWops *context)
+	{
+		if (context)
+		{
+			//HACK: technically speaking `hidden` is an implementation detail, but we need to use it to release the mapping (similar to `mzops_close`)
+			if (context->hidden.mem.base)
+			{
+				CrossPlatform::unmapFile(context->hidden.mem.base, context->hidden.mem.stop - context->hidden.mem.base);
+			}
+			SDL_FreeRW(context);
+		}
+		return 0;
+	};
+	return rv;
+}
+
+/**
+ * Memory maps a loose file and warps it in RWops, the mapping is released on close.
+ * @param fullpath - file to map
+ * @return RWops or NULL if the file can't be mapped.
+ */
+static SDL_RWops *SDL_RWFromMappedFile(const std::string& fullpath)
+{
+	size_t size = 0;
+	const void *data = CrossPlatform::mapFile(fullpath, size);
+	return SDL_RWFromMapping(data, size);
+}
+
+/**
+ * Memory maps the extracted copy of a zipped file from the disk cache,
+ * extracting it there first if it is missing or does not match the zip entry.
+ * @param frec - zipped file record with a cache path
+ * @param size - set to the size of the mapping
+ * @return Mapped data or NULL if the cache can't be used.
+ */
+static const void *mapZipCache(const FileRecord& frec, size_t& size)
+{
+	auto zip = (mz_zip_archive *)frec.zip;
+	mz_zip_archive_file_stat fistat;
+	if (!mz_zip_reader_file_stat(zip, (mz_uint)frec.findex, &fistat)) { return NULL; }
+
+	const void *data = CrossPlatform::mapFile(frec.cachepath, size);
+	if (data && size == fistat.m_uncomp_size) { return data; }
+	if (data) { CrossPlatform::unmapFile(data, size); }
+
+	size_t extracted = 0;
+	void *unzipped = mz_zip_reader_extract_to_heap(zip, (mz_uint)frec.findex, &extracted, 0);
+	if (!unzipped) { return NULL; }
+	// write to a temporary file first and rename it over, so an interrupted write never leaves a truncated copy behind
+	std::string tmppath = frec.cachepath + ".tmp";
+	SDL_RWops *out = SDL_RWFromFile(tmppath.c_str(), "wb");
+	bool written = out && SDL_RWwrite(out, unzipped, extracted, 1) == 1;
+	if (out) { written = (SDL_RWclose(out) == 0) && written; }
+	mz_free(unzipped);
+	if (!written || !CrossPlatform::renameFile(tmppath, frec.cachepath)) {
+		Log(LOG_WARNING) << "Failed to write zip cache file " << frec.cachepath << " for " << frec.fullpath;
+		CrossPlatform::deleteFile(tmppath);
+		return NULL;
+	}
+	data = CrossPlatform::mapFile(frec.cachepath, size);
+	if (data && size != fistat.m_uncomp_size) {
+		CrossPlatform::unmapFile(data, size);
+		return NULL;
+	}
+	return data;
+}
+
+/**
+ * Read only stream over the content of a FileView, owns the view.
+ */
+class FileViewStreamBuf : public std::streambuf
+{
+	std::unique_ptr<FileView> _view;
+
+public:
+	FileViewStreamBuf(std::unique_ptr<FileView> view) : _view(std::move(view))
+	{
+		char *begin = (char *)_view->begin();
+		setg(begin, begin, (char *)_view->end());
+	}
+
+protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+	{
+		char *pos = dir == std::ios_base::beg ? eback() : dir == std::ios_base::cur ? gptr() : egptr();
+		if (off < eback() - pos || off > egptr() - pos)
+		{
+			return pos_type(off_type(-1));
+		}
+		pos += off;
+		setg(eback(), pos, egptr());
+		return pos_type(off_type(pos - eback()));
+	}
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+};
+
+class FileViewIStream : public std::istream
+{
+	FileViewStreamBuf _buf;
+
+public:
+	FileViewIStream(std::unique_ptr<FileView> view) : std::istream(nullptr), _buf(std::move(view))
+	{
+		rdbuf(&_buf);
+	}
+};
+
+FileRecord::FileRecord() : fullpath(""), zip(NULL), findex(0), cachepath() { }
 
 SDL_RWops *FileRecord::getRWops() const
 {
 	SDL_RWops *rv;
 	if (zip != NULL) {
-		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
+		size_t size = 0;
+		rv = cachepath.empty() ? NULL : SDL_RWFromMapping(mapZipCache(*this, size), size);
+		if (!rv) { rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex); }
 	} else {
-		rv = SDL_RWFromFile(fullpath.c_str(), "rb");
+		rv = SDL_RWFromMappedFile(fullpath);
+		if (!rv) { rv = SDL_RWFromFile(fullpath.c_str(), "rb"); }
 	}
 	if (!rv) { Log(LOG_ERROR) << "FileRecord::getRWops(): err=" << SDL_GetError(); }
 	return rv;
@@ -224,7 +357,13 @@ SDL_RWops *FileRecord::getRWopsReadAll() const
 	SDL_RWops *rv;
 	if (zip != NULL)
 	{
-		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
+		size_t size = 0;
+		rv = cachepath.empty() ? NULL : SDL_RWFromMapping(mapZipCache(*this, size), size);
+		if (!rv) { rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex); }
+	}
+	else if ((rv = SDL_RWFromMappedFile(fullpath)))
+	{
+		// nothing to copy, all the data is already in memory
 	}
 	else
 	{
@@ -262,24 +401,42 @@ SDL_RWops *FileRecord::getRWopsReadAll() const
 	return rv;
 }
 
-std::unique_ptr<std::istream> FileRecord::getIStream() const
+std::unique_ptr<FileView> FileRecord::getView() const
 {
 	if (zip != NULL) {
-		size_t size;
+		size_t size = 0;
+		const void *mapped = cachepath.empty() ? NULL : mapZipCache(*this, size);
+		if (mapped) {
+			return std::make_unique<FileView>((const Uint8 *)mapped, size, [](const Uint8 *d, size_t s) { CrossPlatform::unmapFile(d, s); });
+		}
 		void *data = mz_zip_reader_extract_to_heap((mz_zip_archive *)zip, findex, &size, 0);
 		if (data == NULL) {
-			auto err = "FileRecord::getIStream(): failed to decompress " + fullpath + ": ";
+			auto err = "FileRecord::getView(): failed to decompress " + fullpath + ": ";
 			err += mz_zip_get_error_string(mz_zip_get_last_error((mz_zip_archive *)zip));
 			Log(LOG_FATAL) << err;
 			throw Exception(err);
 		}
-		std::string a_string((char *)data, size);
-		auto rv = new std::stringstream(a_string);
-		mz_free(data);
-		return std::unique_ptr<std::istream>(rv);
-	} else {
-		return CrossPlatform::readFile(fullpath);
+		return std::make_unique<FileView>((const Uint8 *)data, size, [](const Uint8 *d, size_t) { mz_free((void *)d); });
+	}
+	size_t size = 0;
+	const void *mapped = CrossPlatform::mapFile(fullpath, size);
+	if (mapped) {
+		return std::make_unique<FileView>((const Uint8 *)mapped, size, [](const Uint8 *d, size_t s) { CrossPlatform::unmapFile(d, s); });
 	}
+	// empty files or file systems without memory mapping support
+	SDL_RWops *rwops = SDL_RWFromFile(fullpath.c_str(), "rb");
+	void *data = rwops ? SDL_LoadFile_RW(rwops, &size, SDL_TRUE) : NULL;
+	if (data == NULL) {
+		auto err = "FileRecord::getView(): failed to read " + fullpath + ": " + SDL_GetError();
+		Log(LOG_FATAL) << err;
+		throw Exception(err);
+	}
+	return std::make_unique<FileView>((const Uint8 *)data, size, [](const Uint8 *d, size_t) { SDL_free((void *)d); });
+}
+
+std::unique_ptr<std::istream> FileRecord::getIStream() const
+{
+	return std::make_unique<FileViewIStream>(getView());
 }
 
 YAML::Node FileRecord::getYAML() const
@@ -358,6 +515,69 @@ typedef std::unordered_map<std::string, FileRecord> FileSet;
 static const NameSet emptySet;
 static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwops);
 
+/// Name of the file in a zip cache folder that holds the path of its zip.
+static const std::string zipCacheSourceFile = "source";
+
+/**
+ * Deletes the zip cache folders that can no longer be used: the ones
+ * made for an older version of the given zip, and the ones whose zip is gone.
+ * Cache folders of zips that are still around but not loaded now are kept.
+ * @param zippath - path to the .zip the current folder belongs to
+ * @param current - name of the current cache folder of that zip
+ */
+static void pruneZipCache(const std::string& zippath, const std::string& current)
+{
+	const std::string& cachedir = Options::getCacheFolder();
+	for (const auto& entry : CrossPlatform::getFolderContents(cachedir))
+	{
+		const std::string& name = std::get<0>(entry);
+		if (!std::get<1>(entry) || name.compare(0, 4, "zip_") != 0 || name == current) { continue; }
+		std::string folder = cachedir + name;
+		std::string source;
+		if (CrossPlatform::fileExists(folder + "/" + zipCacheSourceFile))
+		{
+			auto in = CrossPlatform::readFile(folder + "/" + zipCacheSourceFile);
+			std::getline(*in, source);
+		}
+		if (source.empty() || source == zippath || !CrossPlatform::fileExists(source))
+		{
+			if (CrossPlatform::deleteFolder(folder)) {
+				Log(LOG_VERBOSE) << "Deleted stale zip cache folder " << folder;
+			} else {
+				Log(LOG_WARNING) << "Failed to delete stale zip cache folder " << folder;
+			}
+		}
+	}
+}
+
+/**
+ * Gets the disk cache folder for files extracted from a zip.
+ * The folder is keyed by the zip path, size and modification time,
+ * so any change to the zip moves it to a fresh folder, and the
+ * folder of the older version is deleted.
+ * @param zippath - path to the .zip
+ * @param zip - opened zip
+ * @return Folder path with the trailing slash, or empty string if caching is not possible.
+ */
+static std::string getZipCacheFolder(const std::string& zippath, mz_zip_archive *zip)
+{
+	if (!Options::oxceZipCache || !CrossPlatform::fileExists(zippath) || !CrossPlatform::folderExists(Options::getCacheFolder())) {
+		return "";
+	}
+	std::ostringstream key;
+	key << zippath << '\n' << zip->m_archive_size << '\n' << CrossPlatform::getDateModified(zippath);
+	std::string name = "zip_" + MD5(key.str()).hexdigest();
+	std::string folder = Options::getCacheFolder() + name + "/";
+	if (!CrossPlatform::folderExists(folder)) {
+		if (!CrossPlatform::createFolder(folder) || !CrossPlatform::writeFile(folder + zipCacheSourceFile, zippath + "\n")) {
+			Log(LOG_WARNING) << "Failed to create zip cache folder " << folder;
+			return "";
+		}
+		pruneZipCache(zippath, name);
+	}
+	return folder;
+}
+
 struct VFSLayer {
 	std::string fullpath;				// the origin
 	FileSet resources; 					// relpath -> frec.
@@ -464,6 +684,7 @@ struct VFSLayer {
 
 		FileRecord frec;
 		frec.zip = zip;
+		std::string cachedir = getZipCacheFolder(zippath, zip);
 
 		mz_uint mapped_count = 0;
 		for (mz_uint fi = 0; fi < filecount; ++fi) {
@@ -486,6 +707,12 @@ struct VFSLayer {
 			}
 			frec.findex = fi;
 			frec.fullpath = concatPaths(fullpath, fname);
+			frec.cachepath.clear();
+			if (!cachedir.empty() && fistat.m_uncomp_size > 0) {
+				std::ostringstream cachename;
+				cachename << cachedir << fi << '_' << std::hex << fistat.m_crc32;
+				frec.cachepath = cachename.str();
+			}
 
 			if (isRuleset(relfname) && ignore_ruls) { continue; }
 			insert(relfname, frec);
@@ -495,16 +722,25 @@ struct VFSLayer {
 		return mapped_count > 1;
 	}
 	bool mapPlainDir(const std::string& dirpath, bool ignore_ruls = false) {
-		std::string log_ctx = "mapPlainDir(" + dirpath + ", " + (ignore_ruls ? "true" : "false") + "): ";
+		dirlist_t dlist;
+		if (!ls_r(dirpath, "", dlist)) {
+			return false;
+		}
+		return mapDirList(dirpath, dlist, ignore_ruls);
+	}
+	/** maps a moddir from an already made listing
+	* @param dirpath - the directory the listing is relative to
+	* @param dlist - recursive listing of the directory
+	* @param ignore_ruls - skip rulesets
+	* @return - did we map anything
+	*/
+	bool mapDirList(const std::string& dirpath, const dirlist_t& dlist, bool ignore_ruls = false) {
+		std::string log_ctx = "mapDirList(" + dirpath + ", " + (ignore_ruls ? "true" : "false") + "): ";
 		if (mapped) {
 			auto err = log_ctx + "fatal: already mapped.";
 			Log(LOG_FATAL) << err;
 			throw Exception(err);
 		}
-		dirlist_t dlist;
-		if (!ls_r(dirpath, "", dlist)) {
-			return false;
-		}
 		fullpath = dirpath;
 		FileRecord frec;
 		frec.zip = NULL;
@@ -733,6 +969,7 @@ void clear(bool clearOnly, bool embeddedOnly) {
 */
 void setup(const std::vector<const ModInfo* >& active, bool embeddedOnly)
 {
+	ProfilerScope profile("filemap", "FileMap::setup");
 	TheVFS.clear();
 	TheVFS.map_common(embeddedOnly);
 	std::string log_ctx = "FileMap::setup(): ";
@@ -761,6 +998,7 @@ void setup(const std::vector<const ModInfo* >& active, bool embeddedOnly)
 	for (auto i = map_order.begin(); i !=  map_order.end(); ++i) {
 		if (mods_seen.find(*i) != mods_seen.end()) { continue; }
 		mods_seen.insert(*i);
+		ProfilerScope profileMod("filemap", "FileMap::setup", *i);
 		TheVFS.push_back( ModsAvailable.at(*i));
 	}
 	Log(LOG_VERBOSE) << log_ctx << "Active VFS stack:";
@@ -1005,6 +1243,218 @@ SDL_RWops *zipGetFileByName(const std::string& zipfile, const std::string& fullp
 	SDL_free(mzip);
 	return NULL;
 }
+/*
+ * Persistent cache of the scanned mod directories.
+ *
+ * Each entry keeps the listing of every directory of a mod dir and the raw metadata.yml,
+ * along with their modification times. Adding, removing or renaming a file changes
+ * the mtime of its directory, so only the directories whose mtime changed are listed again.
+ * Mtimes only have a resolution of seconds: anything listed or read in the same second
+ * it was last modified is stored with a zero mtime, so it is read again next time.
+ */
+struct ModScanDir {
+	time_t mtime;	// 0 if it has to be listed again
+	std::vector<std::pair<std::string, bool>> contents;	// <name, is subfolder>, in the order of getFolderContents()
+
+	ModScanDir() : mtime(0), contents() { }
+};
+struct ModScanEntry {
+	std::unordered_map<std::string, ModScanDir> dirs;	// relpath -> listing, "" being the mod dir itself
+	std::string metadataPath;
+	time_t metadataTime;	// 0 if it has to be read again
+	std::string metadata;
+	bool used;
+
+	ModScanEntry() : dirs(), metadataPath(), metadataTime(0), metadata(), used(false) { }
+};
+static std::unordered_map<std::string, ModScanEntry> ModScanCache;	// modpath -> entry
+static bool ModScanCacheLoaded = false;
+static bool ModScanCacheDirty = false;
+static const std::string ModScanCacheHeader = "OXCE mod scan cache 2";
+
+static std::string getModScanCacheFile() { return Options::getCacheFolder() + "modscan.dat"; }
+
+/**
+ * Loads the mod scan cache from disk, once per run.
+ * Any inconsistency just drops the whole cache.
+ */
+static void loadModScanCache() {
+	if (ModScanCacheLoaded) { return; }
+	ModScanCacheLoaded = true;
+	auto filename = getModScanCacheFile();
+	if (!CrossPlatform::fileExists(filename)) { return; }
+	std::unique_ptr<std::istream> in;
+	try {
+		in = CrossPlatform::readFile(filename);
+	} catch (Exception &) {
+		return;
+	}
+	std::string line;
+	if (!std::getline(*in, line) || line != ModScanCacheHeader) { return; }
+
+	ModScanEntry *entry = nullptr;
+	ModScanDir *dir = nullptr;
+	bool ok = true;
+	while (ok && std::getline(*in, line)) {
+		auto sep = line.find(' ');
+		auto tag = line.substr(0, sep);
+		auto rest = (sep == line.npos) ? std::string() : line.substr(sep + 1);
+		if (tag == "mod") {
+			entry = &ModScanCache[rest];
+			dir = nullptr;
+		} else if (!entry) {
+			ok = false;
+		} else if (tag == "dir") {
+			long long mtime;
+			std::istringstream hdr(rest);
+			ok = (bool)(hdr >> mtime) && hdr.get() == ' ';
+			std::string relpath;
+			std::getline(hdr, relpath);
+			dir = &entry->dirs[relpath];
+			dir->mtime = (time_t)mtime;
+		} else if (tag == "file" || tag == "sub") {
+			ok = dir != nullptr;
+			if (ok) { dir->contents.push_back(std::make_pair(rest, tag == "sub")); }
+		} else if (tag == "meta") {
+			long long mtime;
+			size_t size;
+			std::istringstream hdr(rest);
+			ok = (bool)(hdr >> mtime >> size) && hdr.get() == ' ';
+			std::getline(hdr, entry->metadataPath);
+			entry->metadataTime = (time_t)mtime;
+			entry->metadata.resize(size);
+			ok = ok && in->read(&entry->metadata[0], size) && in->get() == '\n';
+		} else if (tag == "end") {
+			entry = nullptr;
+			dir = nullptr;
+		} else {
+			ok = false;
+		}
+	}
+	if (!ok || entry) {
+		Log(LOG_WARNING) << "Ignoring corrupt mod scan cache " << filename;
+		ModScanCache.clear();
+	}
+}
+
+/**
+ * Finds the cache entry for the mod dir.
+ * @param modpath - mod dir
+ * @return the entry or nullptr if the dir was never scanned.
+ */
+static const ModScanEntry *findModScan(const std::string& modpath) {
+	if (!Options::oxceDiskCache) { return nullptr; }
+	loadModScanCache();
+	auto it = ModScanCache.find(modpath);
+	if (it == ModScanCache.end()) { return nullptr; }
+	it->second.used = true;
+	return &it->second;
+}
+
+/**
+ * Recursively lists a mod dir like ls_r(), reusing the cached listings
+ * of the directories that did not change since they were cached.
+ * @param basePath - mod dir
+ * @param relPath - directory to list, relative to the mod dir
+ * @param cached - cache entry of the mod dir, or nullptr
+ * @param entry - gets the listings of all the directories
+ * @param dlist - gets the files
+ * @return number of directories that had to be listed.
+ */
+static int ls_cached(const std::string &basePath, const std::string &relPath, const ModScanEntry *cached, ModScanEntry& entry, dirlist_t& dlist) {
+	auto fullDir = concatOptionalPaths(basePath, relPath);
+	auto& dir = entry.dirs[relPath];
+	// taken before listing so a change made meanwhile is not missed
+	dir.mtime = CrossPlatform::getDateModified(fullDir);
+	int listed = 0;
+	const ModScanDir *old = nullptr;
+	if (cached) {
+		auto it = cached->dirs.find(relPath);
+		if (it != cached->dirs.end()) { old = &it->second; }
+	}
+	if (old && old->mtime != 0 && old->mtime == dir.mtime) {
+		dir.contents = old->contents;
+	} else {
+		if (dir.mtime >= time(nullptr)) { dir.mtime = 0; }
+		auto files = CrossPlatform::getFolderContents(fullDir);
+		for (auto i = files.begin(); i != files.end(); ++i) {
+			if (std::get<1>(*i)) { // it's a subfolder
+				if (CrossPlatform::folderExists(concatPaths(fullDir, std::get<0>(*i)))) {
+					dir.contents.push_back(std::make_pair(std::get<0>(*i), true));
+				}
+			} else {
+				dir.contents.push_back(std::make_pair(std::get<0>(*i), false));
+			}
+		}
+		listed = 1;
+	}
+	for (auto i = dir.contents.begin(); i != dir.contents.end(); ++i) {
+		if (i->second) {
+			listed += ls_cached(basePath, concatOptionalPaths(relPath, i->first), cached, entry, dlist);
+		} else {
+			dlist.push_back(std::make_pair(relPath, i->first));
+		}
+	}
+	return listed;
+}
+
+/**
+ * Remembers a freshly scanned mod dir.
+ * Listings that can't be stored in the line based format are not cached.
+ */
+static void storeModScan(const std::string& modpath, ModScanEntry entry) {
+	if (!Options::oxceDiskCache) { return; }
+	auto storable = [](const std::string& str) { return str.find_first_of("\n\r") == str.npos; };
+	bool valid = storable(modpath) && storable(entry.metadataPath);
+	for (auto di = entry.dirs.cbegin(); valid && di != entry.dirs.cend(); ++di) {
+		valid = storable(di->first);
+		for (auto fi = di->second.contents.cbegin(); valid && fi != di->second.contents.cend(); ++fi) {
+			valid = storable(fi->first);
+		}
+	}
+	if (!valid) { return; }
+	entry.used = true;
+	ModScanCache[modpath] = std::move(entry);
+	ModScanCacheDirty = true;
+}
+
+/**
+ * Writes the mod scan cache out if anything changed,
+ * dropping the entries for mod dirs that were not seen since the last save.
+ */
+void saveModScanCache() {
+	if (!Options::oxceDiskCache || !ModScanCacheLoaded) { return; }
+	for (auto it = ModScanCache.begin(); it != ModScanCache.end(); ) {
+		if (!it->second.used) {
+			it = ModScanCache.erase(it);
+			ModScanCacheDirty = true;
+		} else {
+			it->second.used = false;
+			++it;
+		}
+	}
+	if (!ModScanCacheDirty || !CrossPlatform::folderExists(Options::getCacheFolder())) { return; }
+	ModScanCacheDirty = false;
+
+	std::ostringstream out;
+	out << ModScanCacheHeader << '\n';
+	for (const auto& mod : ModScanCache) {
+		const auto& entry = mod.second;
+		out << "mod " << mod.first << '\n';
+		for (const auto& dir : entry.dirs) {
+			out << "dir " << (long long)dir.second.mtime << ' ' << dir.first << '\n';
+			for (const auto& item : dir.second.contents) {
+				out << (item.second ? "sub " : "file ") << item.first << '\n';
+			}
+		}
+		out << "meta " << (long long)entry.metadataTime << ' ' << entry.metadata.size() << ' ' << entry.metadataPath << '\n';
+		out << entry.metadata << '\n';
+		out << "end\n";
+	}
+	auto data = out.str();
+	CrossPlatform::writeFile(getModScanCacheFile(), std::vector<unsigned char>(data.begin(), data.end()));
+}
+
 /**
  * this scans a mod dir.
  * which by definition is either a .zip
@@ -1020,6 +1470,7 @@ SDL_RWops *zipGetFileByName(const std::string& zipfile, const std::string& fullp
  *
  */
 void scanModDir(const std::string& dirname, const std::string& basename, bool protectedLocation) {
+	ProfilerScope profile("filemap", "FileMap::scanModDir", dirname + basename);
 
 	// "standard" directory is for built-in mods only! otherwise automatic updates would delete user data
 	const std::set<std::string> standardMods = {
@@ -1113,14 +1564,21 @@ void scanModDir(const std::string& dirname, const std::string& basename, bool pr
 			continue;
 		}
 		auto subpath = concatPaths(fullname, std::get<0>(*zi));
+		ProfilerScope profileZip("filemap", "FileMap::scanModZip", std::get<0>(*zi));
 		scanModZip(subpath);
 	}
 	for (auto di = dirlist.begin(); di != dirlist.end(); ++di) {
 		auto mp_basename = *di;
 		auto modpath = concatPaths(fullname, mp_basename);
+		ProfilerScope profileDir("filemap", "FileMap::scanModDir", mp_basename);
 		// map dat dir! (if it has metadata.yml, naturally)
 		auto layer = new VFSLayer(modpath);
-		if (!layer->mapPlainDir(modpath)) {
+		YAML::Node doc;
+		auto cached = findModScan(modpath);
+		ModScanEntry entry;
+		dirlist_t files;
+		int listed = ls_cached(modpath, "", cached, entry, files);
+		if (!layer->mapDirList(modpath, files)) {
 			Log(LOG_WARNING) << log_ctx << "Can't scan " << mp_basename << ", skipping.";
 			delete layer;
 			continue;
@@ -1131,7 +1589,28 @@ void scanModDir(const std::string& dirname, const std::string& basename, bool pr
 			delete layer;
 			continue;
 		}
-		auto doc = frec->getYAML();
+		entry.metadataPath = frec->fullpath;
+		entry.metadataTime = CrossPlatform::getDateModified(frec->fullpath);
+		bool metadataCached = cached && cached->metadataTime != 0 && cached->metadataTime == entry.metadataTime && cached->metadataPath == entry.metadataPath;
+		if (metadataCached) {
+			entry.metadata = cached->metadata;
+		} else {
+			if (entry.metadataTime >= time(nullptr)) { entry.metadataTime = 0; }
+			auto view = frec->getView();
+			entry.metadata.assign((const char *)view->data(), view->size());
+		}
+		try
+		{
+			doc = YAML::Load(entry.metadata);
+		}
+		catch(...)
+		{
+			Log(LOG_FATAL) << "Error loading file '" << frec->fullpath << "'";
+			throw;
+		}
+		if (doc.IsMap() && (listed > 0 || !metadataCached)) {
+			storeModScan(modpath, std::move(entry));
+		}
 		if (!doc.IsMap()) {
 			Log(LOG_WARNING) << log_ctx << "Bad metadata.yml " << mp_basename << ", skipping.";
 			delete layer;
@@ -1286,6 +1765,9 @@ SDL_RWops *getRWopsReadAll(const std::string &relativeFilePath)
 	return at(relativeFilePath)->getRWopsReadAll();
 }
 
+std::unique_ptr<FileView> getView(const std::string &relativeFilePath) {
+	return at(relativeFilePath)->getView();
+}
 std::unique_ptr<std::istream> getIStream(const std::string &relativeFilePath) {
 	return at(relativeFilePath)->getIStream();
 }
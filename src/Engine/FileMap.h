@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 #include <istream>
+#include <memory>
 #include <unordered_set>
 #include <yaml-cpp/yaml.h>
 #include <SDL_rwops.h>
@@ -36,11 +37,45 @@ namespace OpenXcom
  */
 namespace FileMap
 {
+	/**
+	 * Read only view of the whole content of a file.
+	 * Loose files are memory mapped when possible, so no data is copied,
+	 * zipped ones are decompressed to a buffer owned by the view.
+	 */
+	class FileView
+	{
+	public:
+		/// Function releasing the data.
+		using Release = void (*)(const Uint8 *data, size_t size);
+
+	private:
+		const Uint8 *_data;
+		size_t _size;
+		Release _release;
+
+	public:
+		/// Takes ownership of the data.
+		FileView(const Uint8 *data, size_t size, Release release) : _data(data), _size(size), _release(release) { }
+		/// Releases the data.
+		~FileView() { if (_release) { _release(_data, _size); } }
+
+		FileView(const FileView&) = delete;
+		FileView& operator=(const FileView&) = delete;
+
+		/// Pointer to the first byte of the file.
+		const Uint8 *data() const { return _data; }
+		/// Size of the file in bytes.
+		size_t size() const { return _size; }
+		const Uint8 *begin() const { return _data; }
+		const Uint8 *end() const { return _data + _size; }
+	};
+
 	struct FileRecord {
 		std::string fullpath; 	// includes zip file name if any
 
 		void *zip; 				// borrowed reference/weakref. NOTNULL:
 		size_t findex;       	// file index in the zipfile.
+		std::string cachepath;	// extracted copy of a zipped file, empty if not cached.
 
 		FileRecord();
 
@@ -48,6 +83,8 @@ namespace FileMap
 		SDL_RWops *getRWops() const;
 		/// Read the whole file to memory and warp in RWops.
 		SDL_RWops *getRWopsReadAll() const;
+		/// Get read only view of the whole file, memory mapped if possible.
+		std::unique_ptr<FileView> getView() const;
 
 		std::unique_ptr<std::istream> getIStream() const;
 		YAML::Node getYAML() const;
@@ -66,6 +103,9 @@ namespace FileMap
 	/// Gets SDL_RWops for the file data of a data file blah blah read above. Reads the whole file to memory.
 	SDL_RWops *getRWopsReadAll(const std::string &relativeFilePath);
 
+	/// Gets a read only view of the whole file data, memory mapped if possible.
+	std::unique_ptr<FileView> getView(const std::string &relativeFilePath);
+
 	/// Gets an std::istream interface to the file data. Has to be deleted on the caller's end.
 	std::unique_ptr<std::istream>getIStream(const std::string &relativeFilePath);
 
@@ -110,6 +150,9 @@ namespace FileMap
 	/// scans a moddir for mods, (privately) maps them.
 	void scanModDir(const std::string& dirname, const std::string& basename, bool protectedLocation);
 
+	/// writes out the cached listings of the scanned mod dirs.
+	void saveModScanCache();
+
 	/// scans a .zip from the rwops for mods
 	void scanModZipRW(SDL_RWops *rwops, const std::string& fullpath);
 
@@ -28,8 +28,10 @@
 #include "Music.h"
 #include "Language.h"
 #include "Logger.h"
+#include "Profiler.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/FrameGraph.h"
 #include "../Mod/Mod.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/SavedBattleGame.h"
@@ -56,8 +58,8 @@ const double Game::VOLUME_GRADIENT = 10.0;
  * creates the display screen and sets up the cursor.
  * @param title Title of the game window.
  */
-Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _update(false),  _mouseActive(true), _timeUntilNextFrame(0),
-	_ctrl(false), _alt(false), _shift(false), _rmb(false), _mmb(false)
+Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0), _mod(0), _quit(false), _init(false), _update(false), _fpsCounter(0), _frameGraph(0), _mouseActive(true), _timeUntilNextFrame(0),
+	_ctrl(false), _alt(false), _shift(false), _rmb(false), _mmb(false), _frameDirty(true)
 {
 	Options::reload = false;
 	Options::mute = false;
@@ -101,6 +103,9 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _save(0
 	// Create fps counter
 	_fpsCounter = new FpsCounter(15, 5, 0, 0);
 
+	// Create frame profiler graph
+	_frameGraph = new FrameGraph(160, 64, 0, 6);
+
 	// Create blank language
 	_lang = new Language();
 
@@ -128,6 +133,7 @@ Game::~Game()
 	delete _mod;
 	delete _screen;
 	delete _fpsCounter;
+	delete _frameGraph;
 
 	Mix_CloseAudio();
 
@@ -163,6 +169,7 @@ void Game::run()
 		if (!_init)
 		{
 			_init = true;
+			_frameDirty = true;
 			_states.back()->init();
 
 			// Unpress buttons
@@ -180,10 +187,13 @@ void Game::run()
 		}
 
 		// Process events
+		Uint64 eventsStart = Profiler::now();
 		while (SDL_PollEvent(&_event))
 		{
 			if (CrossPlatform::isQuitShortcut(_event))
 				_event.type = SDL_QUIT;
+			// event handlers may change any state, and the window contents may have been lost
+			_frameDirty = true;
 			switch (_event.type)
 			{
 				case SDL_QUIT:
@@ -277,6 +287,7 @@ void Game::run()
 					_screen->handle(&action);
 					_cursor->handle(&action);
 					_fpsCounter->handle(&action);
+					_frameGraph->handle(&action);
 					if (action.getDetails()->type == SDL_KEYDOWN)
 					{
 						// "ctrl-g" grab input
@@ -328,11 +339,16 @@ void Game::run()
 			}
 		}
 
+		Profiler::addFrameTime(FRAME_EVENTS, Profiler::now() - eventsStart);
+
 		// Process rendering
 		if (runningState != PAUSED)
 		{
 			// Process logic
-			_states.back()->think();
+			{
+				FrameProfilerScope profileThink(FRAME_THINK);
+				_states.back()->think();
+			}
 			_fpsCounter->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
@@ -350,22 +366,22 @@ void Game::run()
 			{
 				// make a note of when this frame update occurred.
 				_timeOfLastFrame = SDL_GetTicks();
-				_fpsCounter->addFrame();
-				_screen->clear();
-				std::list<State*>::iterator i = _states.end();
-				do
+				if (!Options::oxceSkipUnchangedFrames || isFrameDirty())
 				{
-					--i;
-				}
-				while (i != _states.begin() && !(*i)->isScreen());
-
-				for (; i != _states.end(); ++i)
-				{
-					(*i)->blit();
+					_fpsCounter->addFrame();
+					blitStates();
+					_fpsCounter->blit(_screen->getSurface());
+					if (_frameGraph->getVisible())
+					{
+						_frameGraph->invalidate();
+						_frameGraph->blit(_screen->getSurface());
+					}
+					_cursor->blit(_screen->getSurface());
+					_screen->flip();
+					Profiler::endFrame();
+					Surface::clearChanged();
+					_frameDirty = false;
 				}
-				_fpsCounter->blit(_screen->getSurface());
-				_cursor->blit(_screen->getSurface());
-				_screen->flip();
 			}
 		}
 
@@ -383,6 +399,53 @@ void Game::run()
 	Options::save();
 }
 
+/**
+ * Checks if anything on screen could have changed since the last
+ * frame: an event was handled, the state stack changed, a surface
+ * was drawn on or moved, or a visible surface is waiting to be redrawn.
+ * @return True if the frame has to be composed and put on screen.
+ */
+bool Game::isFrameDirty() const
+{
+	if (_frameDirty || Surface::isChanged() || _frameGraph->getVisible() || _fpsCounter->isRedrawPending())
+	{
+		return true;
+	}
+	std::list<State*>::const_iterator i = _states.end();
+	do
+	{
+		--i;
+		if ((*i)->isRedrawPending())
+		{
+			return true;
+		}
+	}
+	while (i != _states.begin() && !(*i)->isScreen());
+	return false;
+}
+
+/**
+ * Blits all the visible states onto the screen, starting
+ * from the topmost full-screen state.
+ */
+void Game::blitStates()
+{
+	FrameProfilerScope profile(FRAME_BLIT);
+	_screen->clear();
+	std::list<State*>::iterator i = _states.end();
+	do
+	{
+		--i;
+	}
+	while (i != _states.begin() && !(*i)->isScreen());
+
+	for (; i != _states.end(); ++i)
+	{
+		FrameStateProfilerScope profileState(typeid(**i));
+		(*i)->blit();
+	}
+}
+
 /**
  * Stops the state machine and the game is shut down.
  */
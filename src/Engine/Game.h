@@ -32,6 +32,7 @@ class SavedGame;
 class Mod;
 class ModInfo;
 class FpsCounter;
+class FrameGraph;
 class Action;
 class GeoscapeState;
 
@@ -53,12 +54,19 @@ private:
 	Mod *_mod;
 	bool _quit, _init, _update;
 	FpsCounter *_fpsCounter;
+	FrameGraph *_frameGraph;
 	bool _mouseActive;
 	unsigned int _timeOfLastFrame;
 	int _timeUntilNextFrame;
 	bool _ctrl, _alt, _shift, _rmb, _mmb;
+	bool _frameDirty;
 	static const double VOLUME_GRADIENT;
 
+	/// Checks if anything on screen could have changed since the last frame.
+	bool isFrameDirty() const;
+	/// Blits the visible states onto the screen.
+	void blitStates();
+
 public:
 	/// Creates a new game and initializes SDL.
 	Game(const std::string &title);
@@ -78,6 +86,8 @@ public:
 	Cursor *getCursor() const { return _cursor; }
 	/// Gets the FpsCounter.
 	FpsCounter *getFpsCounter() const { return _fpsCounter; }
+	/// Gets the frame profiler graph.
+	FrameGraph *getFrameGraph() const { return _frameGraph; }
 	/// Resets the state stack to a new state.
 	void setState(State *state);
 	/// Pushes a new state into the state stack.
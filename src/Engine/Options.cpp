@@ -34,6 +34,7 @@
 #include "../Menu/ModConfirmExtendedState.h"
 #include "FileMap.h"
 #include "Screen.h"
+#include "Profiler.h"
 
 namespace OpenXcom
 {
@@ -53,6 +54,7 @@ std::map<std::string, std::string> _commandLine;
 std::vector<OptionInfo> _info;
 std::map<std::string, ModInfo> _modInfos;
 std::string _masterMod;
+std::string _traceFile;
 int _passwordCheck = -1;
 bool _loadLastSave = false;
 bool _loadLastSaveExpended = false;
@@ -275,6 +277,22 @@ void create()
 
 	_info.push_back(OptionInfo("oxceEmbeddedOnly", &oxceEmbeddedOnly, true));
 	_info.push_back(OptionInfo("oxceListVFSContents", &oxceListVFSContents, false));
+	_info.push_back(OptionInfo("oxceDiskCache", &oxceDiskCache, true));
+	_info.push_back(OptionInfo("oxceZipCache", &oxceZipCache, false));
+	_info.push_back(OptionInfo("oxceScalerThreads", &oxceScalerThreads, 0));
+	_info.push_back(OptionInfo("oxceSkipUnchangedFrames", &oxceSkipUnchangedFrames, true));
+	_info.push_back(OptionInfo("oxceBattleScrollBlit", &oxceBattleScrollBlit, true));
+	_info.push_back(OptionInfo("oxceBattleTerrainLayer", &oxceBattleTerrainLayer, true));
+	_info.push_back(OptionInfo("oxceBattleRenderThreads", &oxceBattleRenderThreads, 1));
+	_info.push_back(OptionInfo("oxceScriptOptimize", &oxceScriptOptimize, true));
+	_info.push_back(OptionInfo("oxceScriptProfiler", &oxceScriptProfiler, false));
+	_info.push_back(OptionInfo("keyScriptProfiler", &keyScriptProfiler, SDLK_F8));
+	_info.push_back(OptionInfo("oxceBattleReplayRecord", &oxceBattleReplayRecord, false));
+	_info.push_back(OptionInfo("oxceBattleReplay", &oxceBattleReplay, ""));
+	_info.push_back(OptionInfo("oxceTurboAITurns", &oxceTurboAITurns, true));
+	_info.push_back(OptionInfo("oxceAIPlanAhead", &oxceAIPlanAhead, true));
+	_info.push_back(OptionInfo("oxceBrutalAIBudget", &oxceBrutalAIBudget, 0));
+	_info.push_back(OptionInfo("oxceAIDecisionTrace", &oxceAIDecisionTrace, false));
 	_info.push_back(OptionInfo("oxceRawScreenShots", &oxceRawScreenShots, false));
 	_info.push_back(OptionInfo("oxceFirstPersonViewFisheyeProjection", &oxceFirstPersonViewFisheyeProjection, false));
 	_info.push_back(OptionInfo("oxceThumbButtons", &oxceThumbButtons, true));
@@ -434,6 +452,7 @@ void create()
 	_info.push_back(OptionInfo("keyNightVisionToggle", &keyNightVisionToggle, SDLK_SCROLLOCK, "STR_TOGGLE_NIGHT_VISION", "STR_OXCE"));
 	_info.push_back(OptionInfo("keyNightVisionHold", &keyNightVisionHold, SDLK_SPACE, "STR_HOLD_NIGHT_VISION", "STR_OXCE"));
 	_info.push_back(OptionInfo("keySelectMusicTrack", &keySelectMusicTrack, SDLK_END, "STR_SELECT_MUSIC_TRACK", "STR_OXCE"));
+	_info.push_back(OptionInfo("keyFrameProfiler", &keyFrameProfiler, SDLK_F6, "STR_FRAME_PROFILER", "STR_OXCE"));
 	
 	_info.push_back(OptionInfo("keyAIList", &keyAIList, SDLK_c, "STR_keyAIList", "STR_OXCE"));
 
@@ -564,6 +583,10 @@ static void loadArgs()
 				{
 					_masterMod = argv[i];
 				}
+				else if (argname == "trace")
+				{
+					_traceFile = argv[i];
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -596,6 +619,8 @@ static bool showHelp()
 	help << "        use PATH as the default Config Folder instead of auto-detecting" << std::endl << std::endl;
 	help << "-master MOD" << std::endl;
 	help << "        set MOD to the current master mod (eg. -master xcom2)" << std::endl << std::endl;
+	help << "-trace FILE" << std::endl;
+	help << "        record the startup phases to FILE, open it in chrome://tracing or Perfetto" << std::endl << std::endl;
 	help << "-KEY VALUE" << std::endl;
 	help << "        override option KEY with VALUE (eg. -displayWidth 640)" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -697,6 +722,11 @@ bool init()
 	Log(LOG_INFO) << "Config folder is: " << _configFolder;
 	Log(LOG_INFO) << "Options loaded successfully.";
 
+	if (!_traceFile.empty())
+	{
+		Profiler::startTrace(_traceFile);
+	}
+
 	FileMap::clear(false, Options::oxceEmbeddedOnly);
 	return true;
 }
@@ -735,6 +765,8 @@ void refreshMods()
 	}
 #endif
 
+	FileMap::saveModScanCache();
+
 	// Check mods' dependencies on other mods and extResources (UFO, TFTD, etc),
 	// also breaks circular dependency loops.
 	FileMap::checkModsDependencies();
@@ -1014,6 +1046,8 @@ void setFolders()
 	{
 		// create mod folder if it doesn't already exist
 		CrossPlatform::createFolder(_userFolder + "mods");
+		// and the folder for data we can recreate at any time
+		CrossPlatform::createFolder(_userFolder + "cache");
 	}
 
 	if (_configFolder.empty())
@@ -1239,6 +1273,17 @@ std::string getConfigFolder()
 	return _configFolder;
 }
 
+/**
+ * Returns the game's Cache folder where
+ * data derived from the mods is stored.
+ * Everything there can be safely deleted.
+ * @return Full path to Cache folder.
+ */
+std::string getCacheFolder()
+{
+	return _userFolder + "cache/";
+}
+
 /**
  * Returns the game's User folder for the
  * currently loaded master mod.
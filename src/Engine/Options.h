@@ -92,6 +92,8 @@ namespace Options
 	std::string getUserFolder();
 	/// Gets the game's config folder.
 	std::string getConfigFolder();
+	/// Gets the game's cache folder.
+	std::string getCacheFolder();
 	/// Gets the game's master mod user folder.
 	std::string getMasterUserFolder();
 	/// Gets the game's options.
@@ -65,7 +65,7 @@ OPT SDLKey keyGeoDailyPilotExperience, keyGeoUfoTracker, keyGeoTechTreeViewer, k
 	keyBattleShowLayers,
 	keyBattleUseSpecial,
 	keyBattleActionItem1, keyBattleActionItem2, keyBattleActionItem3, keyBattleActionItem4, keyBattleActionItem5,
-	keyNightVisionToggle, keyNightVisionHold, keySelectMusicTrack;
+	keyNightVisionToggle, keyNightVisionHold, keySelectMusicTrack, keyFrameProfiler;
 OPT SDLKey keyBasescapeBuildNewBase, keyBasescapeBaseInfo, keyBasescapeSoldiers, keyBasescapeCrafts,
 	keyBasescapeFacilities, keyBasescapeResearch, keyBasescapeManufacture, keyBasescapeTransfer,
 	keyBasescapePurchase, keyBasescapeSell;
@@ -111,6 +111,26 @@ OPT int oxceModValidationLevel;
 
 OPT bool oxceEmbeddedOnly;
 OPT bool oxceListVFSContents;
+OPT bool oxceDiskCache;
+OPT bool oxceZipCache;
+// 0 = auto detect; 1 = no extra threads
+OPT int oxceScalerThreads;
+OPT bool oxceSkipUnchangedFrames;
+OPT bool oxceBattleScrollBlit;
+OPT bool oxceBattleTerrainLayer;
+// 0 = auto detect; 1 = no extra threads
+OPT int oxceBattleRenderThreads;
+OPT bool oxceScriptOptimize;
+OPT bool oxceScriptProfiler;
+// debug mode key that writes the script profile to the log
+OPT SDLKey keyScriptProfiler;
+// records battles to replayNNN files; a replay name plays that replay on startup
+OPT bool oxceBattleReplayRecord;
+OPT std::string oxceBattleReplay;
+OPT bool oxceTurboAITurns;
+OPT bool oxceAIPlanAhead;
+OPT int oxceBrutalAIBudget;
+OPT bool oxceAIDecisionTrace;
 OPT bool oxceRawScreenShots;
 OPT bool oxceFirstPersonViewFisheyeProjection;
 OPT bool oxceThumbButtons;
@@ -0,0 +1,446 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <typeindex>
+#include <vector>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+#include "CrossPlatform.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+namespace Profiler
+{
+
+namespace
+{
+
+/**
+ * Single finished event.
+ */
+struct TraceEvent
+{
+	const char *category;
+	std::string name;
+	Uint64 start;
+	Uint64 duration;
+	int thread;
+};
+
+std::mutex _traceMutex;
+std::string _traceFile;
+std::vector<TraceEvent> _traceEvents;
+std::map<std::thread::id, int> _traceThreads;
+std::atomic<bool> _tracing(false);
+
+FrameTimes _frames[FRAME_HISTORY];
+FrameTimes _currentFrame;
+int _frameCount = 0;
+int _frameNext = 0;
+
+/// Time of the nested sections, for each frame section being measured.
+const int MAX_OPEN_SECTIONS = 16;
+Uint64 _openSections[MAX_OPEN_SECTIONS];
+int _openCount = 0;
+
+/**
+ * Takes time out of the innermost frame section being measured.
+ * @param duration Duration in microseconds.
+ */
+void addNestedTime(Uint64 duration)
+{
+	if (_openCount > 0 && _openCount <= MAX_OPEN_SECTIONS)
+	{
+		_openSections[_openCount - 1] += duration;
+	}
+}
+
+/**
+ * Ends the innermost frame section being measured,
+ * taking its whole time out of the one it is nested in.
+ * @param duration Duration in microseconds, including nested sections.
+ * @return Duration without the nested sections.
+ */
+Uint64 closeSection(Uint64 duration)
+{
+	Uint64 nested = 0;
+	if (_openCount > 0)
+	{
+		--_openCount;
+		if (_openCount < MAX_OPEN_SECTIONS)
+		{
+			nested = std::min(_openSections[_openCount], duration);
+		}
+	}
+	addNestedTime(duration);
+	return duration - nested;
+}
+
+const char *_frameSectionNames[FRAME_SECTIONS] = { "events", "think", "blit", "terrain", "globe", "zoom", "flip" };
+
+/// Readable names of the state classes seen by the frame profiler.
+std::map<std::type_index, std::string> _stateNames;
+
+/**
+ * Gets a readable name for a state class, without the namespace.
+ * @param type Type of the state.
+ * @return Name that stays valid for the whole run.
+ */
+const char *getStateName(const std::type_info &type)
+{
+	auto i = _stateNames.find(type);
+	if (i == _stateNames.end())
+	{
+		std::string name = type.name();
+#ifdef __GNUC__
+		int status = 0;
+		char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+		if (status == 0 && demangled)
+		{
+			name = demangled;
+		}
+		free(demangled);
+#endif
+		for (const std::string prefix : { "class ", "OpenXcom::" })
+		{
+			if (name.compare(0, prefix.size(), prefix) == 0)
+			{
+				name.erase(0, prefix.size());
+			}
+		}
+		i = _stateNames.emplace(type, name).first;
+	}
+	return i->second.c_str();
+}
+
+}
+
+/**
+ * Writes a string as a JSON string literal.
+ * @param out Stream to write to.
+ * @param s String to write.
+ */
+void writeJsonString(std::ostream &out, const std::string &s)
+{
+	out << '"';
+	for (char c : s)
+	{
+		switch (c)
+		{
+		case '"': out << "\\\""; break;
+		case '\\': out << "\\\\"; break;
+		case '\n': out << "\\n"; break;
+		case '\r': out << "\\r"; break;
+		case '\t': out << "\\t"; break;
+		default:
+			if ((unsigned char)c < 0x20)
+			{
+				out << ' ';
+			}
+			else
+			{
+				out << c;
+			}
+		}
+	}
+	out << '"';
+}
+
+/**
+ * Gets the current time in microseconds since an unspecified point.
+ * Only differences between returned values are meaningful.
+ * @return Time in microseconds.
+ */
+Uint64 now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Starts recording trace events.
+ * @param filename Path of the file where the trace will be saved.
+ */
+void startTrace(const std::string &filename)
+{
+	std::lock_guard<std::mutex> lock(_traceMutex);
+	_traceFile = filename;
+	_traceEvents.clear();
+	_tracing = true;
+	Log(LOG_INFO) << "Recording startup trace to: " << filename;
+}
+
+/**
+ * Checks if trace recording is enabled.
+ * @return True if events are recorded.
+ */
+bool isTracing()
+{
+	return _tracing;
+}
+
+/**
+ * Adds a finished event to the trace.
+ * @param category Category of the event, used for filtering in the viewer.
+ * @param name Name of the event.
+ * @param start Start time in microseconds.
+ * @param duration Duration in microseconds.
+ */
+void addTraceEvent(const char *category, const std::string &name, Uint64 start, Uint64 duration)
+{
+	std::lock_guard<std::mutex> lock(_traceMutex);
+	if (!_tracing)
+	{
+		return;
+	}
+	auto thread = _traceThreads.insert(std::make_pair(std::this_thread::get_id(), (int)_traceThreads.size() + 1)).first->second;
+	_traceEvents.push_back(TraceEvent{ category, name, start, duration, thread });
+}
+
+/**
+ * Saves all events recorded so far in the Chrome trace event format.
+ * Recording continues, later calls overwrite the file with a longer trace.
+ */
+void saveTrace()
+{
+	std::lock_guard<std::mutex> lock(_traceMutex);
+	if (!_tracing)
+	{
+		return;
+	}
+	Uint64 base = _traceEvents.empty() ? 0 : _traceEvents.front().start;
+	for (const auto& e : _traceEvents)
+	{
+		base = std::min(base, e.start);
+	}
+	std::ostringstream out;
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+	for (const auto& thread : _traceThreads)
+	{
+		if (!first) out << ",\n";
+		first = false;
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.second << ",\"args\":{\"name\":\"" << (thread.second == 1 ? "main" : "worker") << " " << thread.second << "\"}}";
+	}
+	for (const auto& e : _traceEvents)
+	{
+		if (!first) out << ",\n";
+		first = false;
+		out << "{\"name\":";
+		writeJsonString(out, e.name);
+		out << ",\"cat\":\"" << e.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread;
+		out << ",\"ts\":" << (e.start - base) << ",\"dur\":" << e.duration << "}";
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	if (CrossPlatform::writeFile(_traceFile, out.str()))
+	{
+		Log(LOG_INFO) << "Saved trace with " << _traceEvents.size() << " events to: " << _traceFile;
+	}
+}
+
+/**
+ * Adds time spent in a part of the current frame.
+ * Sections can be entered many times per frame, the times add up.
+ * If another section is being measured, the time is taken out of it.
+ * @param section Part of the frame.
+ * @param duration Duration in microseconds.
+ */
+void addFrameTime(FrameSection section, Uint64 duration)
+{
+	_currentFrame.sections[section] += (Uint32)duration;
+	addNestedTime(duration);
+}
+
+/**
+ * Starts measuring a part of the current frame,
+ * nested in the parts already being measured.
+ * @param section Part of the frame.
+ */
+void beginFrameSection(FrameSection section)
+{
+	if (_openCount < MAX_OPEN_SECTIONS)
+	{
+		_openSections[_openCount] = 0;
+	}
+	++_openCount;
+}
+
+/**
+ * Ends measuring the innermost part of the current frame. Only the time
+ * not spent in nested parts is added to it, and the whole time is taken
+ * out of the part it is nested in.
+ * @param section Part of the frame.
+ * @param duration Duration in microseconds, including nested parts.
+ */
+void endFrameSection(FrameSection section, Uint64 duration)
+{
+	_currentFrame.sections[section] += (Uint32)closeSection(duration);
+}
+
+/**
+ * Ends measuring the innermost part of the current frame, which was started
+ * as a blit section for a state. Its time goes to that state instead,
+ * or to the blit section if the frame has no room for more states.
+ * @param type Type of the state.
+ * @param duration Duration in microseconds, including nested parts.
+ */
+void endFrameState(const std::type_info &type, Uint64 duration)
+{
+	Uint32 time = (Uint32)closeSection(duration);
+	const char *name = getStateName(type);
+	for (int i = 0; i < _currentFrame.stateCount; ++i)
+	{
+		if (_currentFrame.states[i].name == name)
+		{
+			_currentFrame.states[i].time += time;
+			return;
+		}
+	}
+	if (_currentFrame.stateCount < FRAME_STATES)
+	{
+		_currentFrame.states[_currentFrame.stateCount++] = { name, time };
+	}
+	else
+	{
+		_currentFrame.sections[FRAME_BLIT] += time;
+	}
+}
+
+/**
+ * Finishes the current frame, storing it in the ring buffer
+ * over the oldest one, and starts a new one.
+ * The total time of a frame runs from the end of the previous one,
+ * so it includes the time spent waiting for the next frame.
+ */
+void endFrame()
+{
+	Uint64 time = now();
+	if (_currentFrame.start != 0)
+	{
+		_currentFrame.total = (Uint32)(time - _currentFrame.start);
+		_frames[_frameNext] = _currentFrame;
+		_frameNext = (_frameNext + 1) % FRAME_HISTORY;
+		_frameCount = std::min(_frameCount + 1, FRAME_HISTORY);
+	}
+	_currentFrame = FrameTimes{};
+	_currentFrame.start = time;
+}
+
+/**
+ * Gets the number of finished frames in the ring buffer.
+ * @return Number of frames, up to FRAME_HISTORY.
+ */
+int getFrameCount()
+{
+	return _frameCount;
+}
+
+/**
+ * Gets a finished frame from the ring buffer.
+ * @param age How many frames back, 0 being the most recent one.
+ * @return Frame times.
+ */
+const FrameTimes &getFrame(int age)
+{
+	return _frames[(_frameNext - 1 - age + 2 * FRAME_HISTORY) % FRAME_HISTORY];
+}
+
+/**
+ * Gets the name of a frame section, as used in the CSV header.
+ * @param section Part of the frame.
+ * @return Section name.
+ */
+const char *getFrameSectionName(FrameSection section)
+{
+	return _frameSectionNames[section];
+}
+
+/**
+ * Saves all frames in the ring buffer as CSV, oldest first,
+ * with one column per section, followed by one column for
+ * each state that was blitted. Times are in microseconds.
+ * @param filename Path of the file.
+ * @return True if the file was saved.
+ */
+bool saveFrames(const std::string &filename)
+{
+	std::ostringstream out;
+	out << "frame,start,total";
+	for (int i = 0; i < FRAME_SECTIONS; ++i)
+	{
+		out << ',' << _frameSectionNames[i];
+	}
+	std::vector<const char*> states;
+	for (int age = _frameCount - 1; age >= 0; --age)
+	{
+		const FrameTimes &f = getFrame(age);
+		for (int i = 0; i < f.stateCount; ++i)
+		{
+			if (std::find(states.begin(), states.end(), f.states[i].name) == states.end())
+			{
+				states.push_back(f.states[i].name);
+				out << ",blit " << f.states[i].name;
+			}
+		}
+	}
+	out << '\n';
+	Uint64 base = _frameCount ? getFrame(_frameCount - 1).start : 0;
+	for (int age = _frameCount - 1, frame = 0; age >= 0; --age, ++frame)
+	{
+		const FrameTimes &f = getFrame(age);
+		out << frame << ',' << (f.start - base) << ',' << f.total;
+		for (int i = 0; i < FRAME_SECTIONS; ++i)
+		{
+			out << ',' << f.sections[i];
+		}
+		for (const char *state : states)
+		{
+			Uint32 time = 0;
+			for (int i = 0; i < f.stateCount; ++i)
+			{
+				if (f.states[i].name == state)
+				{
+					time = f.states[i].time;
+				}
+			}
+			out << ',' << time;
+		}
+		out << '\n';
+	}
+	if (!CrossPlatform::writeFile(filename, out.str()))
+	{
+		return false;
+	}
+	Log(LOG_INFO) << "Saved " << _frameCount << " frame times to: " << filename;
+	return true;
+}
+
+}
+
+}
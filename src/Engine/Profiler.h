@@ -0,0 +1,199 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Parts of a frame measured by the frame profiler.
+ * Sections can nest, e.g. terrain drawing runs during blit and globe
+ * drawing during think or blit. The time of a nested section is taken
+ * out of the section it runs in, so the times of a frame add up.
+ */
+enum FrameSection { FRAME_EVENTS, FRAME_THINK, FRAME_BLIT, FRAME_TERRAIN, FRAME_GLOBE, FRAME_ZOOM, FRAME_FLIP, FRAME_SECTIONS };
+
+/// Number of states whose blit times are kept for each frame.
+const int FRAME_STATES = 8;
+
+/**
+ * Time one state took to blit in a frame, in microseconds.
+ */
+struct FrameStateTime
+{
+	const char *name;
+	Uint32 time;
+};
+
+/**
+ * Times of one rendered frame, in microseconds. The blit of each
+ * state is kept apart under the name of its class, the blit section
+ * only gets what is left, like clearing the screen.
+ */
+struct FrameTimes
+{
+	Uint64 start;
+	Uint32 total;
+	Uint32 sections[FRAME_SECTIONS];
+	FrameStateTime states[FRAME_STATES];
+	int stateCount;
+};
+
+/**
+ * Lightweight instrumentation of the engine.
+ * Recorded events can be saved in the Chrome trace format
+ * that can be opened by chrome://tracing or Perfetto.
+ */
+namespace Profiler
+{
+	/// Gets the current time in microseconds.
+	Uint64 now();
+	/// Starts recording trace events, they will be saved to the given file.
+	void startTrace(const std::string &filename);
+	/// Is trace recording enabled?
+	bool isTracing();
+	/// Adds a finished event to the trace.
+	void addTraceEvent(const char *category, const std::string &name, Uint64 start, Uint64 duration);
+	/// Saves all events recorded so far to the trace file.
+	void saveTrace();
+	/// Writes a string as a JSON string literal.
+	void writeJsonString(std::ostream &out, const std::string &s);
+
+	/// Number of frames kept by the frame profiler.
+	const int FRAME_HISTORY = 256;
+	/// Adds time spent in a part of the current frame.
+	void addFrameTime(FrameSection section, Uint64 duration);
+	/// Starts a part of the current frame, nested in the one already started.
+	void beginFrameSection(FrameSection section);
+	/// Ends the innermost part of the current frame.
+	void endFrameSection(FrameSection section, Uint64 duration);
+	/// Ends the innermost part of the current frame, which was the blit of a state.
+	void endFrameState(const std::type_info &type, Uint64 duration);
+	/// Finishes the current frame and starts a new one.
+	void endFrame();
+	/// Gets the number of finished frames available.
+	int getFrameCount();
+	/// Gets a finished frame, 0 being the most recent one.
+	const FrameTimes &getFrame(int age);
+	/// Gets the name of a frame section.
+	const char *getFrameSectionName(FrameSection section);
+	/// Saves the recorded frames as CSV.
+	bool saveFrames(const std::string &filename);
+}
+
+/**
+ * Measures the time spent in a scope and adds it to the trace.
+ * Does nothing if trace recording is not enabled.
+ */
+class ProfilerScope
+{
+	const char *_category;
+	std::string _name;
+	Uint64 _start;
+
+public:
+	/// Starts measuring.
+	ProfilerScope(const char *category, const std::string &name) : _category(nullptr), _start(0)
+	{
+		if (Profiler::isTracing())
+		{
+			_category = category;
+			_name = name;
+			_start = Profiler::now();
+		}
+	}
+	/// Starts measuring, the name is made of two parts joined only when tracing.
+	ProfilerScope(const char *category, const std::string &name, const std::string &detail) : _category(nullptr), _start(0)
+	{
+		if (Profiler::isTracing())
+		{
+			_category = category;
+			_name = name + " " + detail;
+			_start = Profiler::now();
+		}
+	}
+	/// Ends measuring.
+	~ProfilerScope()
+	{
+		if (_category)
+		{
+			Profiler::addTraceEvent(_category, _name, _start, Profiler::now() - _start);
+		}
+	}
+
+	ProfilerScope(const ProfilerScope&) = delete;
+	ProfilerScope& operator=(const ProfilerScope&) = delete;
+};
+
+/**
+ * Measures the time spent in a scope and adds it to a section of the
+ * current frame, minus the sections nested in it. Main thread only.
+ */
+class FrameProfilerScope
+{
+	FrameSection _section;
+	Uint64 _start;
+
+public:
+	/// Starts measuring.
+	FrameProfilerScope(FrameSection section) : _section(section), _start(Profiler::now())
+	{
+		Profiler::beginFrameSection(section);
+	}
+	/// Ends measuring.
+	~FrameProfilerScope()
+	{
+		Profiler::endFrameSection(_section, Profiler::now() - _start);
+	}
+
+	FrameProfilerScope(const FrameProfilerScope&) = delete;
+	FrameProfilerScope& operator=(const FrameProfilerScope&) = delete;
+};
+
+/**
+ * Measures the time a state takes to blit and adds it to the current
+ * frame under the name of its class, minus the sections nested in it.
+ * Main thread only.
+ */
+class FrameStateProfilerScope
+{
+	const std::type_info &_type;
+	Uint64 _start;
+
+public:
+	/// Starts measuring.
+	FrameStateProfilerScope(const std::type_info &type) : _type(type), _start(Profiler::now())
+	{
+		Profiler::beginFrameSection(FRAME_BLIT);
+	}
+	/// Ends measuring.
+	~FrameStateProfilerScope()
+	{
+		Profiler::endFrameState(_type, Profiler::now() - _start);
+	}
+
+	FrameStateProfilerScope(const FrameStateProfilerScope&) = delete;
+	FrameStateProfilerScope& operator=(const FrameStateProfilerScope&) = delete;
+};
+
+}
@@ -37,15 +37,48 @@
 #define trU   0x00000700
 #define trV   0x00000006
 
-/* RGB to YUV lookup table */
-extern uint32_t RGBtoYUV[16777216];
-
+/* RGB to YUV conversion, same rounding as the former 16M entry lookup table */
 static inline uint32_t rgb_to_yuv(uint32_t c)
 {
-    // Mask against MASK_RGB to discard the alpha channel
-    return RGBtoYUV[MASK_RGB & c];
+    uint32_t r = (c & 0xFF0000) >> 16;
+    uint32_t g = (c & 0x00FF00) >> 8;
+    uint32_t b = c & 0x0000FF;
+    uint32_t y = (uint32_t)(0.299*r + 0.587*g + 0.114*b);
+    uint32_t u = (uint32_t)((int)(-0.169*r - 0.331*g + 0.5*b) + 128);
+    uint32_t v = (uint32_t)((int)(0.5*r - 0.419*g - 0.081*b) + 128);
+    return (y << 16) + (u << 8) + v;
 }
 
+/*
+ * Small direct mapped cache of YUV values.
+ * Our frames are made from 8-bit palettized surfaces, so only a few hundred distinct colors
+ * are on screen at once and nearly every lookup hits, without the cache misses of a 64 MB table.
+ * Each scaler call keeps its own, so slices of the same image can be scaled by multiple threads.
+ */
+struct YuvCache
+{
+    enum { SIZE = 4096, VALID = 0x01000000 };
+    uint32_t rgb[SIZE]; /* with the VALID bit set */
+    uint32_t yuv[SIZE];
+
+    YuvCache()
+    {
+        for (int i = 0; i < SIZE; i++)
+            rgb[i] = 0;
+    }
+    uint32_t get(uint32_t c)
+    {
+        /* Mask against MASK_RGB to discard the alpha channel */
+        c &= MASK_RGB;
+        uint32_t h = (c ^ (c >> 12) ^ (c >> 20)) & (SIZE - 1);
+        if (rgb[h] != (c | VALID))
+        {
+            rgb[h] = c | VALID;
+            yuv[h] = rgb_to_yuv(c);
+        }
+        return yuv[h];
+    }
+};
 
 /* Test if there is difference in color */
 static inline int yuv_diff(uint32_t yuv1, uint32_t yuv2) {
@@ -54,11 +87,6 @@ static inline int yuv_diff(uint32_t yuv1, uint32_t yuv2) {
             ( abs((int)((yuv1 & Vmask) - (yuv2 & Vmask))) > trV ) );
 }
 
-static inline int Diff(uint32_t c1, uint32_t c2)
-{
-    return yuv_diff(rgb_to_yuv(c1), rgb_to_yuv(c2));
-}
-
 /* Interpolate functions */
 static inline uint32_t Interpolate_2(uint32_t c1, int w1, uint32_t c2, int w2, int s)
 {
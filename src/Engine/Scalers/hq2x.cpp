@@ -71,16 +71,22 @@
 #define PIXEL11_90    *(dp+dpL+1) = Interp9(w[5], w[6], w[8]);
 #define PIXEL11_100   *(dp+dpL+1) = Interp10(w[5], w[6], w[8]);
 
-HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+HQX_API void HQX_CALLCONV hq2x_32_rb_slice(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres, int yFirst, int yLast )
 {
     int  i, j, k;
     int  prevline, nextline;
     uint32_t  w[10];
     int dpL = (drb >> 2);
     int spL = (srb >> 2);
-    const uint8_t* sRowP = (const uint8_t*) sp;
-    const uint8_t* dRowP = (const uint8_t*) dp;
-    uint32_t yuv1, yuv2;
+    if (yFirst < 0) yFirst = 0;
+    if (yLast > Yres) yLast = Yres;
+    const uint8_t* sRowP = (const uint8_t*) sp + srb * yFirst;
+    const uint8_t* dRowP = (const uint8_t*) dp + drb * 2 * yFirst;
+    uint32_t yuv[10];
+    YuvCache yuvCache;
+
+    sp = (const uint32_t*) sRowP;
+    dp = (uint32_t*) dRowP;
 
     //   +----+----+----+
     //   |    |    |    |
@@ -93,7 +99,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    for (j=yFirst; j<yLast; j++)
     {
         if (j>0)      prevline = -spL;
         else prevline = 0;
@@ -135,7 +141,22 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
             int pattern = 0;
             int flag = 1;
 
-            yuv1 = rgb_to_yuv(w[5]);
+            if (i>0)
+            {
+                /* the left and middle columns are the previous pixel's middle and right ones */
+                yuv[1] = yuv[2]; yuv[2] = yuv[3];
+                yuv[4] = yuv[5]; yuv[5] = yuv[6];
+                yuv[7] = yuv[8]; yuv[8] = yuv[9];
+            }
+            else
+            {
+                yuv[1] = yuvCache.get(w[1]); yuv[2] = yuvCache.get(w[2]);
+                yuv[4] = yuvCache.get(w[4]); yuv[5] = yuvCache.get(w[5]);
+                yuv[7] = yuvCache.get(w[7]); yuv[8] = yuvCache.get(w[8]);
+            }
+            yuv[3] = yuvCache.get(w[3]);
+            yuv[6] = yuvCache.get(w[6]);
+            yuv[9] = yuvCache.get(w[9]);
 
             for (k=1; k<=9; k++)
             {
@@ -143,8 +164,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
 
                 if ( w[k] != w[5] )
                 {
-                    yuv2 = rgb_to_yuv(w[k]);
-                    if (yuv_diff(yuv1, yuv2))
+                    if (yuv_diff(yuv[5], yuv[k]))
                         pattern |= flag;
                 }
                 flag <<= 1;
@@ -311,7 +331,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 50:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -329,7 +349,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_22
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -344,7 +364,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -358,7 +378,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 10:
                 case 138:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -431,7 +451,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 54:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -449,7 +469,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_22
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -464,7 +484,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -478,7 +498,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 11:
                 case 139:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -494,7 +514,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 19:
                 case 51:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_11
                         PIXEL01_10
@@ -512,7 +532,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 178:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                         PIXEL11_12
@@ -529,7 +549,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 85:
                 {
                     PIXEL00_20
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL01_11
                         PIXEL11_10
@@ -547,7 +567,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_20
                     PIXEL01_22
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL10_12
                         PIXEL11_10
@@ -564,7 +584,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                         PIXEL11_11
@@ -579,7 +599,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 73:
                 case 77:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_12
                         PIXEL10_10
@@ -596,7 +616,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 42:
                 case 170:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                         PIXEL10_11
@@ -613,7 +633,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 14:
                 case 142:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                         PIXEL01_12
@@ -694,7 +714,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 26:
                 case 31:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -702,7 +722,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -718,7 +738,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 214:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -727,7 +747,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_20
                     }
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -742,7 +762,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_22
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -750,7 +770,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -763,7 +783,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 74:
                 case 107:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -772,7 +792,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_21
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -785,7 +805,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 27:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -801,7 +821,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 86:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -818,7 +838,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_21
                     PIXEL01_22
                     PIXEL10_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -832,7 +852,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_10
                     PIXEL01_21
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -846,7 +866,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 30:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -863,7 +883,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_22
                     PIXEL01_10
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -877,7 +897,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_22
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -890,7 +910,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 75:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1001,7 +1021,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 58:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1009,7 +1029,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1024,7 +1044,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 83:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1033,7 +1053,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_70
                     }
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1047,7 +1067,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1055,7 +1075,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1067,7 +1087,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 202:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1076,7 +1096,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_70
                     }
                     PIXEL01_21
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1089,7 +1109,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 78:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1098,7 +1118,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_70
                     }
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1111,7 +1131,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 154:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1119,7 +1139,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1134,7 +1154,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 114:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1143,7 +1163,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_70
                     }
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1157,7 +1177,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_22
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1165,7 +1185,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1177,7 +1197,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 90:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1185,7 +1205,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1193,7 +1213,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_70
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1201,7 +1221,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1214,7 +1234,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 55:
                 case 23:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_11
                         PIXEL01_0
@@ -1232,7 +1252,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 150:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                         PIXEL11_12
@@ -1249,7 +1269,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 212:
                 {
                     PIXEL00_20
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL01_11
                         PIXEL11_0
@@ -1267,7 +1287,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_20
                     PIXEL01_22
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL10_12
                         PIXEL11_0
@@ -1284,7 +1304,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                         PIXEL11_11
@@ -1299,7 +1319,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 109:
                 case 105:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_12
                         PIXEL10_0
@@ -1316,7 +1336,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 171:
                 case 43:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL10_11
@@ -1333,7 +1353,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 143:
                 case 15:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_12
@@ -1351,7 +1371,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -1364,7 +1384,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 203:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1380,7 +1400,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 62:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -1397,7 +1417,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_11
                     PIXEL01_10
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -1410,7 +1430,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 118:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -1427,7 +1447,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_12
                     PIXEL01_22
                     PIXEL10_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -1441,7 +1461,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_10
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -1454,7 +1474,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 155:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1535,7 +1555,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1543,7 +1563,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -1555,7 +1575,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 158:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1563,7 +1583,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -1577,7 +1597,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 234:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1586,7 +1606,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_70
                     }
                     PIXEL01_21
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -1600,7 +1620,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 242:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1609,7 +1629,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_70
                     }
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -1621,7 +1641,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 59:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1629,7 +1649,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1645,7 +1665,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_22
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -1653,7 +1673,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1666,7 +1686,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 87:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -1675,7 +1695,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_20
                     }
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1687,7 +1707,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 79:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1696,7 +1716,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1709,7 +1729,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 122:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1717,7 +1737,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1725,7 +1745,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_70
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -1733,7 +1753,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1745,7 +1765,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 94:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1753,7 +1773,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -1761,7 +1781,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_20
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1769,7 +1789,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1781,7 +1801,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 218:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1789,7 +1809,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1797,7 +1817,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_70
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1805,7 +1825,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -1817,7 +1837,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 91:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -1825,7 +1845,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1833,7 +1853,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_70
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1841,7 +1861,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1885,7 +1905,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 186:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1893,7 +1913,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_70
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1908,7 +1928,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 115:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -1917,7 +1937,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_70
                     }
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1931,7 +1951,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1939,7 +1959,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_70
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -1951,7 +1971,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 206:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -1960,7 +1980,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_70
                     }
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1976,7 +1996,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_10
                     }
@@ -1990,7 +2010,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 174:
                 case 46:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_10
                     }
@@ -2007,7 +2027,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 147:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_10
                     }
@@ -2025,7 +2045,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_11
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_10
                     }
@@ -2054,7 +2074,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 126:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2062,7 +2082,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_20
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2075,7 +2095,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 219:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2085,7 +2105,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL01_10
                     PIXEL10_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2097,7 +2117,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 125:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_12
                         PIXEL10_0
@@ -2114,7 +2134,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 221:
                 {
                     PIXEL00_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL01_11
                         PIXEL11_0
@@ -2129,7 +2149,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 207:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_12
@@ -2147,7 +2167,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_10
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                         PIXEL11_11
@@ -2162,7 +2182,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 190:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                         PIXEL11_12
@@ -2177,7 +2197,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 187:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL10_11
@@ -2195,7 +2215,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_11
                     PIXEL01_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL10_12
                         PIXEL11_0
@@ -2209,7 +2229,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 119:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_11
                         PIXEL01_0
@@ -2228,7 +2248,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_20
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2242,7 +2262,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 175:
                 case 47:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2259,7 +2279,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 151:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2277,7 +2297,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_11
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2291,7 +2311,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_10
                     PIXEL01_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2299,7 +2319,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2311,7 +2331,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 123:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2320,7 +2340,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2333,7 +2353,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 95:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2341,7 +2361,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2356,7 +2376,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 222:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2365,7 +2385,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_20
                     }
                     PIXEL10_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2379,7 +2399,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_21
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2387,7 +2407,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2401,7 +2421,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_22
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2409,7 +2429,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_100
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2421,7 +2441,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 235:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2430,7 +2450,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_21
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2443,7 +2463,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 111:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2452,7 +2472,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_100
                     }
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2465,7 +2485,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 63:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2473,7 +2493,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_100
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2487,7 +2507,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 159:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2495,7 +2515,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2510,7 +2530,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 215:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2519,7 +2539,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_100
                     }
                     PIXEL10_21
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2532,7 +2552,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 246:
                 {
                     PIXEL00_22
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2541,7 +2561,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_20
                     }
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2554,7 +2574,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 254:
                 {
                     PIXEL00_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2562,7 +2582,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_20
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2570,7 +2590,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_20
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2584,7 +2604,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_12
                     PIXEL01_11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2592,7 +2612,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_100
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2604,7 +2624,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 251:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2613,7 +2633,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2621,7 +2641,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_100
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2633,7 +2653,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 239:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2642,7 +2662,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_100
                     }
                     PIXEL01_12
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2655,7 +2675,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 127:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2663,7 +2683,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_100
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2671,7 +2691,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_20
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2684,7 +2704,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 191:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2692,7 +2712,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_100
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2706,7 +2726,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 223:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2714,7 +2734,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_20
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2723,7 +2743,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_100
                     }
                     PIXEL10_10
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2736,7 +2756,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 247:
                 {
                     PIXEL00_11
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2745,7 +2765,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_100
                     }
                     PIXEL10_12
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2757,7 +2777,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 255:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -2765,7 +2785,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_100
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_0
                     }
@@ -2773,7 +2793,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL01_100
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_0
                     }
@@ -2781,7 +2801,7 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL10_100
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL11_0
                     }
@@ -2804,6 +2824,11 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     }
 }
 
+HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+{
+    hq2x_32_rb_slice(sp, srb, dp, drb, Xres, Yres, 0, Yres);
+}
+
 HQX_API void HQX_CALLCONV hq2x_32(const uint32_t* sp, uint32_t* dp, int Xres, int Yres )
 {
     uint32_t rowBytesL = Xres * 4;
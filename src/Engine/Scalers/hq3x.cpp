@@ -76,16 +76,22 @@
 #define PIXEL22_5   *(dp+dpL+dpL+2) = Interp5(w[6], w[8]);
 #define PIXEL22_C   *(dp+dpL+dpL+2) = w[5];
 
-HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+HQX_API void HQX_CALLCONV hq3x_32_rb_slice(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres, int yFirst, int yLast )
 {
     int  i, j, k;
     int  prevline, nextline;
     uint32_t  w[10];
     int dpL = (drb >> 2);
     int spL = (srb >> 2);
-    const uint8_t* sRowP = (const uint8_t*) sp;
-    const uint8_t* dRowP = (const uint8_t*) dp;
-    uint32_t yuv1, yuv2;
+    if (yFirst < 0) yFirst = 0;
+    if (yLast > Yres) yLast = Yres;
+    const uint8_t* sRowP = (const uint8_t*) sp + srb * yFirst;
+    const uint8_t* dRowP = (const uint8_t*) dp + drb * 3 * yFirst;
+    uint32_t yuv[10];
+    YuvCache yuvCache;
+
+    sp = (const uint32_t*) sRowP;
+    dp = (uint32_t*) dRowP;
 
     //   +----+----+----+
     //   |    |    |    |
@@ -98,7 +104,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    for (j=yFirst; j<yLast; j++)
     {
         if (j>0)      prevline = -spL;
         else prevline = 0;
@@ -140,7 +146,22 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
             int pattern = 0;
             int flag = 1;
 
-            yuv1 = rgb_to_yuv(w[5]);
+            if (i>0)
+            {
+                /* the left and middle columns are the previous pixel's middle and right ones */
+                yuv[1] = yuv[2]; yuv[2] = yuv[3];
+                yuv[4] = yuv[5]; yuv[5] = yuv[6];
+                yuv[7] = yuv[8]; yuv[8] = yuv[9];
+            }
+            else
+            {
+                yuv[1] = yuvCache.get(w[1]); yuv[2] = yuvCache.get(w[2]);
+                yuv[4] = yuvCache.get(w[4]); yuv[5] = yuvCache.get(w[5]);
+                yuv[7] = yuvCache.get(w[7]); yuv[8] = yuvCache.get(w[8]);
+            }
+            yuv[3] = yuvCache.get(w[3]);
+            yuv[6] = yuvCache.get(w[6]);
+            yuv[9] = yuvCache.get(w[9]);
 
             for (k=1; k<=9; k++)
             {
@@ -148,8 +169,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
 
                 if ( w[k] != w[5] )
                 {
-                    yuv2 = rgb_to_yuv(w[k]);
-                    if (yuv_diff(yuv1, yuv2))
+                    if (yuv_diff(yuv[5], yuv[k]))
                         pattern |= flag;
                 }
                 flag <<= 1;
@@ -381,7 +401,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 50:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_1M
@@ -409,7 +429,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_1
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -431,7 +451,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_2
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_1M
@@ -449,7 +469,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 10:
                 case 138:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                         PIXEL01_C
@@ -559,7 +579,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 54:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -587,7 +607,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_1
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -609,7 +629,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_2
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -627,7 +647,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 11:
                 case 139:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -650,7 +670,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 19:
                 case 51:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_1L
                         PIXEL01_C
@@ -674,7 +694,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 146:
                 case 178:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_1M
@@ -698,7 +718,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 84:
                 case 85:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL02_1U
                         PIXEL12_C
@@ -722,7 +742,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 112:
                 case 113:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL20_1L
@@ -746,7 +766,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 200:
                 case 204:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_1M
@@ -770,7 +790,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 73:
                 case 77:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_1U
                         PIXEL10_C
@@ -794,7 +814,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 42:
                 case 170:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                         PIXEL01_C
@@ -818,7 +838,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 14:
                 case 142:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                         PIXEL01_C
@@ -946,7 +966,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 26:
                 case 31:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL10_C
@@ -957,7 +977,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_3
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                         PIXEL12_C
@@ -977,7 +997,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 214:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -991,7 +1011,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11
                     PIXEL12_C
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL21_C
                         PIXEL22_C
@@ -1010,7 +1030,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL01_1
                     PIXEL02_1M
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -1021,7 +1041,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_4
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL22_C
@@ -1036,7 +1056,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 74:
                 case 107:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1050,7 +1070,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                         PIXEL21_C
@@ -1065,7 +1085,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 27:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1088,7 +1108,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 86:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -1115,7 +1135,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -1136,7 +1156,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -1154,7 +1174,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 30:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -1181,7 +1201,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_1
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -1202,7 +1222,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -1219,7 +1239,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 75:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1397,7 +1417,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 58:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -1406,7 +1426,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -1426,7 +1446,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -1439,7 +1459,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1M
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -1457,7 +1477,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -1466,7 +1486,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -1478,7 +1498,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 202:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -1491,7 +1511,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -1505,7 +1525,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 78:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -1518,7 +1538,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -1532,7 +1552,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 154:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -1541,7 +1561,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -1561,7 +1581,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1M
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -1574,7 +1594,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -1592,7 +1612,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -1601,7 +1621,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -1613,7 +1633,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 90:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -1622,7 +1642,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -1633,7 +1653,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -1642,7 +1662,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -1655,7 +1675,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 55:
                 case 23:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_1L
                         PIXEL01_C
@@ -1679,7 +1699,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 182:
                 case 150:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -1703,7 +1723,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 213:
                 case 212:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL02_1U
                         PIXEL12_C
@@ -1727,7 +1747,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 241:
                 case 240:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL20_1L
@@ -1751,7 +1771,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 236:
                 case 232:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -1775,7 +1795,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 109:
                 case 105:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_1U
                         PIXEL10_C
@@ -1799,7 +1819,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 171:
                 case 43:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1823,7 +1843,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 143:
                 case 15:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1851,7 +1871,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1U
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -1868,7 +1888,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 203:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -1891,7 +1911,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 62:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -1918,7 +1938,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_1
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -1935,7 +1955,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 118:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -1962,7 +1982,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -1983,7 +2003,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1R
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2000,7 +2020,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 155:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2131,7 +2151,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1U
                     PIXEL10_C
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2139,7 +2159,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL20_2
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -2155,7 +2175,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 158:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2163,7 +2183,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_2
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -2184,7 +2204,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 234:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2196,7 +2216,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2215,7 +2235,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1M
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2226,7 +2246,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_1
                     PIXEL11
                     PIXEL20_1L
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -2242,7 +2262,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 59:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2254,7 +2274,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_3
                         PIXEL10_3
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2276,7 +2296,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2288,7 +2308,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_4
                         PIXEL21_3
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2301,7 +2321,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 87:
                 {
                     PIXEL00_1L
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -2317,7 +2337,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11
                     PIXEL20_1M
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2329,7 +2349,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 79:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2344,7 +2364,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1R
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2358,7 +2378,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 122:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2367,7 +2387,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2377,7 +2397,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2389,7 +2409,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_4
                         PIXEL21_3
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2401,7 +2421,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 94:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2409,7 +2429,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL00_2
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -2423,7 +2443,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL10_C
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2432,7 +2452,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2444,7 +2464,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 218:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2453,7 +2473,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2463,7 +2483,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL10_C
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2471,7 +2491,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     {
                         PIXEL20_2
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -2487,7 +2507,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 91:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2499,7 +2519,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_3
                         PIXEL10_3
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2509,7 +2529,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2518,7 +2538,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2582,7 +2602,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 186:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2591,7 +2611,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2611,7 +2631,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2624,7 +2644,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2642,7 +2662,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2651,7 +2671,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2663,7 +2683,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 206:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2676,7 +2696,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2697,7 +2717,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_1M
                     }
@@ -2712,7 +2732,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 174:
                 case 46:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_1M
                     }
@@ -2735,7 +2755,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_1M
                     }
@@ -2762,7 +2782,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_1M
                     }
@@ -2801,7 +2821,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 126:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -2814,7 +2834,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL12_3
                     }
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2831,7 +2851,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 219:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2846,7 +2866,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -2862,7 +2882,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 125:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_1U
                         PIXEL10_C
@@ -2885,7 +2905,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 221:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL02_1U
                         PIXEL12_C
@@ -2908,7 +2928,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 207:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -2931,7 +2951,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 238:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -2954,7 +2974,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 190:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -2977,7 +2997,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 187:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -3000,7 +3020,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 243:
                 {
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL20_1L
@@ -3023,7 +3043,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 119:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_1L
                         PIXEL01_C
@@ -3053,7 +3073,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3068,7 +3088,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 175:
                 case 47:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3091,7 +3111,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3118,7 +3138,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3134,7 +3154,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL01_C
                     PIXEL02_1M
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -3145,7 +3165,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_4
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL22_C
@@ -3159,7 +3179,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 123:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -3173,7 +3193,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                         PIXEL21_C
@@ -3188,7 +3208,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 95:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL10_C
@@ -3199,7 +3219,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_3
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                         PIXEL12_C
@@ -3218,7 +3238,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 222:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -3232,7 +3252,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11
                     PIXEL12_C
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL21_C
                         PIXEL22_C
@@ -3251,7 +3271,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1U
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -3262,7 +3282,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_4
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3279,7 +3299,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL02_1M
                     PIXEL10_C
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3288,7 +3308,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL22_C
@@ -3302,7 +3322,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 235:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -3316,7 +3336,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3330,7 +3350,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 111:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3343,7 +3363,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                         PIXEL21_C
@@ -3358,7 +3378,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 63:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3367,7 +3387,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                         PIXEL12_C
@@ -3386,7 +3406,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 159:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL10_C
@@ -3397,7 +3417,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_3
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3416,7 +3436,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3428,7 +3448,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11
                     PIXEL12_C
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL21_C
                         PIXEL22_C
@@ -3443,7 +3463,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 246:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -3458,7 +3478,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3471,7 +3491,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 254:
                 {
                     PIXEL00_1M
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -3482,7 +3502,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL02_4
                     }
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -3492,7 +3512,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_3
                         PIXEL20_4
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL21_C
@@ -3514,7 +3534,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3523,7 +3543,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3535,7 +3555,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 251:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -3547,7 +3567,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL02_1M
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL10_C
                         PIXEL20_C
@@ -3559,7 +3579,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                         PIXEL21_3
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL12_C
                         PIXEL22_C
@@ -3573,7 +3593,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 239:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3586,7 +3606,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_1
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3600,7 +3620,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 127:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL01_C
@@ -3612,7 +3632,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_3
                         PIXEL10_3
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                         PIXEL12_C
@@ -3623,7 +3643,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL12_3
                     }
                     PIXEL11
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                         PIXEL21_C
@@ -3638,7 +3658,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 191:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3647,7 +3667,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3665,7 +3685,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 223:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                         PIXEL10_C
@@ -3675,7 +3695,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_4
                         PIXEL10_3
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL01_C
                         PIXEL02_C
@@ -3689,7 +3709,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL11
                     PIXEL20_1M
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL21_C
                         PIXEL22_C
@@ -3705,7 +3725,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_1L
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3718,7 +3738,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_C
                     PIXEL20_1L
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3730,7 +3750,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 255:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_C
                     }
@@ -3739,7 +3759,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_2
                     }
                     PIXEL01_C
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_C
                     }
@@ -3750,7 +3770,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_C
                     PIXEL11
                     PIXEL12_C
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_C
                     }
@@ -3759,7 +3779,7 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL20_2
                     }
                     PIXEL21_C
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_C
                     }
@@ -3782,6 +3802,11 @@ HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     }
 }
 
+HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+{
+    hq3x_32_rb_slice(sp, srb, dp, drb, Xres, Yres, 0, Yres);
+}
+
 HQX_API void HQX_CALLCONV hq3x_32(const uint32_t* sp, uint32_t* dp, int Xres, int Yres )
 {
     uint32_t rowBytesL = Xres * 4;
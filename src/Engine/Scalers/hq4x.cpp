@@ -163,16 +163,22 @@
 #define PIXEL33_81    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[6]);
 #define PIXEL33_82    *(dp+dpL+dpL+dpL+3) = Interp8(w[5], w[8]);
 
-HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+HQX_API void HQX_CALLCONV hq4x_32_rb_slice(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres, int yFirst, int yLast )
 {
     int  i, j, k;
     int  prevline, nextline;
     uint32_t w[10];
     int dpL = (drb >> 2);
     int spL = (srb >> 2);
-    const uint8_t* sRowP = (const uint8_t*) sp;
-    const uint8_t* dRowP = (const uint8_t*) dp;
-    uint32_t yuv1, yuv2;
+    if (yFirst < 0) yFirst = 0;
+    if (yLast > Yres) yLast = Yres;
+    const uint8_t* sRowP = (const uint8_t*) sp + srb * yFirst;
+    const uint8_t* dRowP = (const uint8_t*) dp + drb * 4 * yFirst;
+    uint32_t yuv[10];
+    YuvCache yuvCache;
+
+    sp = (const uint32_t*) sRowP;
+    dp = (uint32_t*) dRowP;
 
     //   +----+----+----+
     //   |    |    |    |
@@ -185,7 +191,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     //   | w7 | w8 | w9 |
     //   +----+----+----+
 
-    for (j=0; j<Yres; j++)
+    for (j=yFirst; j<yLast; j++)
     {
         if (j>0)      prevline = -spL;
         else prevline = 0;
@@ -227,7 +233,22 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
             int pattern = 0;
             int flag = 1;
 
-            yuv1 = rgb_to_yuv(w[5]);
+            if (i>0)
+            {
+                /* the left and middle columns are the previous pixel's middle and right ones */
+                yuv[1] = yuv[2]; yuv[2] = yuv[3];
+                yuv[4] = yuv[5]; yuv[5] = yuv[6];
+                yuv[7] = yuv[8]; yuv[8] = yuv[9];
+            }
+            else
+            {
+                yuv[1] = yuvCache.get(w[1]); yuv[2] = yuvCache.get(w[2]);
+                yuv[4] = yuvCache.get(w[4]); yuv[5] = yuvCache.get(w[5]);
+                yuv[7] = yuvCache.get(w[7]); yuv[8] = yuvCache.get(w[8]);
+            }
+            yuv[3] = yuvCache.get(w[3]);
+            yuv[6] = yuvCache.get(w[6]);
+            yuv[9] = yuvCache.get(w[9]);
 
             for (k=1; k<=9; k++)
             {
@@ -235,8 +256,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
 
                 if ( w[k] != w[5] )
                 {
-                    yuv2 = rgb_to_yuv(w[k]);
-                    if (yuv_diff(yuv1, yuv2))
+                    if (yuv_diff(yuv[5], yuv[k]))
                         pattern |= flag;
                 }
                 flag <<= 1;
@@ -560,7 +580,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -599,7 +619,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL13_10
                     PIXEL20_61
                     PIXEL21_30
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -628,7 +648,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_70
                     PIXEL13_60
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -651,7 +671,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 10:
                 case 138:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -812,7 +832,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -851,7 +871,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_61
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -878,7 +898,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_70
                     PIXEL13_60
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -900,7 +920,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 11:
                 case 139:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -930,7 +950,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 19:
                 case 51:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_81
                         PIXEL01_31
@@ -965,7 +985,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -999,7 +1019,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_60
                     PIXEL02_81
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL03_81
                         PIXEL13_31
@@ -1039,7 +1059,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL13_10
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -1070,7 +1090,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_70
                     PIXEL13_60
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -1095,7 +1115,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 73:
                 case 77:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_82
                         PIXEL10_32
@@ -1128,7 +1148,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 42:
                 case 170:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -1161,7 +1181,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 14:
                 case 142:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -1354,7 +1374,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 26:
                 case 31:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -1366,7 +1386,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_50
                         PIXEL10_50
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -1395,7 +1415,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -1413,7 +1433,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_61
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -1440,7 +1460,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -1454,7 +1474,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL21_0
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -1471,7 +1491,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 74:
                 case 107:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -1488,7 +1508,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_0
                     PIXEL12_30
                     PIXEL13_61
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -1509,7 +1529,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 27:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -1540,7 +1560,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -1578,7 +1598,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_10
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -1604,7 +1624,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_30
                     PIXEL13_61
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -1627,7 +1647,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -1665,7 +1685,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_61
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -1691,7 +1711,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -1712,7 +1732,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 75:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -1981,7 +2001,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 58:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -1995,7 +2015,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -2023,7 +2043,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_81
                     PIXEL01_31
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -2041,7 +2061,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_31
                     PIXEL20_61
                     PIXEL21_30
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -2069,7 +2089,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_31
                     PIXEL13_31
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -2083,7 +2103,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -2101,7 +2121,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 202:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -2119,7 +2139,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL03_80
                     PIXEL12_30
                     PIXEL13_61
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -2141,7 +2161,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 78:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -2159,7 +2179,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL03_82
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -2181,7 +2201,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 154:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -2195,7 +2215,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -2223,7 +2243,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -2241,7 +2261,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -2269,7 +2289,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_32
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -2283,7 +2303,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -2301,7 +2321,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 90:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -2315,7 +2335,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -2329,7 +2349,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL12_0
                         PIXEL13_12
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -2343,7 +2363,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -2362,7 +2382,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 55:
                 case 23:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_81
                         PIXEL01_31
@@ -2397,7 +2417,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -2431,7 +2451,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_20
                     PIXEL01_60
                     PIXEL02_81
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL03_81
                         PIXEL13_31
@@ -2471,7 +2491,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL13_10
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_0
                         PIXEL23_0
@@ -2502,7 +2522,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_70
                     PIXEL13_60
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL21_0
@@ -2527,7 +2547,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 109:
                 case 105:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_82
                         PIXEL10_32
@@ -2560,7 +2580,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 171:
                 case 43:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -2593,7 +2613,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 143:
                 case 15:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -2633,7 +2653,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_31
                     PIXEL13_31
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -2654,7 +2674,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 203:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -2685,7 +2705,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -2723,7 +2743,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_61
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -2743,7 +2763,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -2781,7 +2801,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_10
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -2807,7 +2827,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -2828,7 +2848,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 155:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -3025,7 +3045,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_31
                     PIXEL13_31
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3040,7 +3060,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL31_11
                     }
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -3056,7 +3076,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 158:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3070,7 +3090,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -3095,7 +3115,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 234:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3113,7 +3133,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL03_80
                     PIXEL12_30
                     PIXEL13_61
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -3136,7 +3156,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3155,7 +3175,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_82
                     PIXEL21_32
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -3173,7 +3193,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 59:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -3185,7 +3205,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_50
                         PIXEL10_50
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3220,7 +3240,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_32
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -3233,7 +3253,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL31_50
                     }
                     PIXEL21_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3253,7 +3273,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_81
                     PIXEL01_31
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -3270,7 +3290,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL12_0
                     PIXEL20_61
                     PIXEL21_30
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3290,7 +3310,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 79:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -3307,7 +3327,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_0
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3329,7 +3349,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 122:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3343,7 +3363,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3357,7 +3377,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL12_0
                         PIXEL13_12
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -3370,7 +3390,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL31_50
                     }
                     PIXEL21_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3388,7 +3408,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 94:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3402,7 +3422,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -3415,7 +3435,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL13_50
                     }
                     PIXEL12_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3429,7 +3449,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3447,7 +3467,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 218:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3461,7 +3481,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3475,7 +3495,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL12_0
                         PIXEL13_12
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3490,7 +3510,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL31_11
                     }
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -3506,7 +3526,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 91:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -3518,7 +3538,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_50
                         PIXEL10_50
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3533,7 +3553,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL13_12
                     }
                     PIXEL11_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3547,7 +3567,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3645,7 +3665,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 186:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3659,7 +3679,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_11
                         PIXEL11_0
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3687,7 +3707,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_81
                     PIXEL01_31
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3705,7 +3725,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_31
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3733,7 +3753,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_32
                     PIXEL12_31
                     PIXEL13_31
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3747,7 +3767,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL30_20
                         PIXEL31_11
                     }
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3765,7 +3785,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 206:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3783,7 +3803,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL03_82
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3814,7 +3834,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_32
                     PIXEL12_70
                     PIXEL13_60
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_10
                         PIXEL21_30
@@ -3837,7 +3857,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 174:
                 case 46:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_80
                         PIXEL01_10
@@ -3870,7 +3890,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_81
                     PIXEL01_31
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_10
                         PIXEL03_80
@@ -3909,7 +3929,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL13_31
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_30
                         PIXEL23_10
@@ -3971,7 +3991,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -3986,7 +4006,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_10
                     PIXEL11_30
                     PIXEL12_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4007,7 +4027,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 219:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4027,7 +4047,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_10
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4045,7 +4065,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 125:
                 {
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL00_82
                         PIXEL10_32
@@ -4080,7 +4100,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_82
                     PIXEL01_82
                     PIXEL02_81
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL03_81
                         PIXEL13_31
@@ -4109,7 +4129,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 207:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4149,7 +4169,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL21_0
@@ -4175,7 +4195,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4205,7 +4225,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 187:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4247,7 +4267,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL13_10
                     PIXEL20_82
                     PIXEL21_32
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL22_0
                         PIXEL23_0
@@ -4269,7 +4289,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 119:
                 {
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL00_81
                         PIXEL01_31
@@ -4314,7 +4334,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL21_0
                     PIXEL22_31
                     PIXEL23_81
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -4330,7 +4350,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 case 175:
                 case 47:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -4361,7 +4381,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_81
                     PIXEL01_31
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -4401,7 +4421,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL30_82
                     PIXEL31_32
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -4421,7 +4441,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4435,7 +4455,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL21_0
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4451,7 +4471,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 123:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4468,7 +4488,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_0
                     PIXEL12_30
                     PIXEL13_10
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4489,7 +4509,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 95:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4501,7 +4521,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL01_50
                         PIXEL10_50
                     }
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4529,7 +4549,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4547,7 +4567,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_10
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4573,7 +4593,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_30
                     PIXEL12_31
                     PIXEL13_31
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4589,7 +4609,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL22_0
                     PIXEL23_0
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -4612,7 +4632,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_0
                     PIXEL21_0
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4624,7 +4644,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL32_50
                         PIXEL33_50
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -4637,7 +4657,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 235:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4658,7 +4678,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL21_0
                     PIXEL22_31
                     PIXEL23_81
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -4673,7 +4693,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 111:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -4688,7 +4708,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL11_0
                     PIXEL12_32
                     PIXEL13_82
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4709,7 +4729,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 63:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -4718,7 +4738,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4745,7 +4765,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 159:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4758,7 +4778,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_50
                     }
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -4784,7 +4804,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_81
                     PIXEL01_31
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -4799,7 +4819,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_61
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4819,7 +4839,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4841,7 +4861,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL30_82
                     PIXEL31_32
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -4855,7 +4875,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 {
                     PIXEL00_80
                     PIXEL01_10
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -4870,7 +4890,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_10
                     PIXEL11_30
                     PIXEL12_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -4886,7 +4906,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL22_0
                     PIXEL23_0
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -4910,7 +4930,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL21_0
                     PIXEL22_0
                     PIXEL23_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -4920,7 +4940,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL31_0
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -4932,7 +4952,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 251:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -4952,7 +4972,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_0
                     PIXEL21_0
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -4964,7 +4984,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL32_50
                         PIXEL33_50
                     }
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -4977,7 +4997,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 239:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -4996,7 +5016,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL21_0
                     PIXEL22_31
                     PIXEL23_81
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -5011,7 +5031,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 127:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -5020,7 +5040,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL00_20
                     }
                     PIXEL01_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL02_0
                         PIXEL03_0
@@ -5035,7 +5055,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL10_0
                     PIXEL11_0
                     PIXEL12_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL20_0
                         PIXEL30_0
@@ -5056,7 +5076,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 191:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -5066,7 +5086,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL01_0
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -5090,7 +5110,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 223:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                         PIXEL01_0
@@ -5103,7 +5123,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                         PIXEL10_50
                     }
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -5117,7 +5137,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL20_10
                     PIXEL21_30
                     PIXEL22_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL23_0
                         PIXEL32_0
@@ -5138,7 +5158,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL00_81
                     PIXEL01_31
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -5157,7 +5177,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL30_82
                     PIXEL31_32
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -5169,7 +5189,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                 }
                 case 255:
                 {
-                    if (Diff(w[4], w[2]))
+                    if (yuv_diff(yuv[4], yuv[2]))
                     {
                         PIXEL00_0
                     }
@@ -5179,7 +5199,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL01_0
                     PIXEL02_0
-                    if (Diff(w[2], w[6]))
+                    if (yuv_diff(yuv[2], yuv[6]))
                     {
                         PIXEL03_0
                     }
@@ -5195,7 +5215,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     PIXEL21_0
                     PIXEL22_0
                     PIXEL23_0
-                    if (Diff(w[8], w[4]))
+                    if (yuv_diff(yuv[8], yuv[4]))
                     {
                         PIXEL30_0
                     }
@@ -5205,7 +5225,7 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
                     }
                     PIXEL31_0
                     PIXEL32_0
-                    if (Diff(w[6], w[8]))
+                    if (yuv_diff(yuv[6], yuv[8]))
                     {
                         PIXEL33_0
                     }
@@ -5228,6 +5248,11 @@ HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t*
     }
 }
 
+HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* sp, uint32_t srb, uint32_t* dp, uint32_t drb, int Xres, int Yres )
+{
+    hq4x_32_rb_slice(sp, srb, dp, drb, Xres, Yres, 0, Yres);
+}
+
 HQX_API void HQX_CALLCONV hq4x_32(const uint32_t* sp, uint32_t* dp, int Xres, int Yres )
 {
     uint32_t rowBytesL = Xres * 4;
@@ -43,7 +43,6 @@
 #define HQX_API
 #endif
 
-HQX_API void HQX_CALLCONV hqxInit(void);
 HQX_API void HQX_CALLCONV hq2x_32(const uint32_t* src, uint32_t* dest, int width, int height );
 HQX_API void HQX_CALLCONV hq3x_32(const uint32_t* src, uint32_t* dest, int width, int height );
 HQX_API void HQX_CALLCONV hq4x_32(const uint32_t* src, uint32_t* dest, int width, int height );
@@ -52,4 +51,10 @@ HQX_API void HQX_CALLCONV hq2x_32_rb(const uint32_t* src, uint32_t src_rowBytes,
 HQX_API void HQX_CALLCONV hq3x_32_rb(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height );
 HQX_API void HQX_CALLCONV hq4x_32_rb(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height );
 
+/* process only the half-open slice of source rows [yFirst, yLast), rows outside of it are still read as neighbours.
+   parts of the same image may be scaled by multiple threads as long as the slices do not overlap. */
+HQX_API void HQX_CALLCONV hq2x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+HQX_API void HQX_CALLCONV hq3x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+HQX_API void HQX_CALLCONV hq4x_32_rb_slice(const uint32_t* src, uint32_t src_rowBytes, uint32_t* dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
+
 #endif
@@ -32,6 +32,7 @@
 #include "CrossPlatform.h"
 #include "FileMap.h"
 #include "Zoom.h"
+#include "Profiler.h"
 #include "Timer.h"
 #include <SDL.h>
 #include <algorithm>
@@ -201,6 +202,7 @@ void Screen::flip()
 		_pushPalette = false;
 	}
 
+	Uint64 zoomStart = Profiler::now();
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || useOpenGL())
 	{
 		Zoom::flipWithZoom(_surface.get(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
@@ -209,6 +211,7 @@ void Screen::flip()
 	{
 		SDL_BlitSurface(_surface.get(), 0, _screen, 0);
 	}
+	Profiler::addFrameTime(FRAME_ZOOM, Profiler::now() - zoomStart);
 
 	// perform any requested palette update
 	if (!_flickerFix && _pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
@@ -223,6 +226,7 @@ void Screen::flip()
 
 
 
+	FrameProfilerScope profileFlip(FRAME_FLIP);
 	if (SDL_Flip(_screen) == -1)
 	{
 		throw Exception(SDL_GetError());
@@ -263,6 +267,7 @@ void Screen::setPalette(const SDL_Color* colors, int firstcolor, int ncolors, bo
 	}
 
 	SDL_SetColors(_surface.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
+	Surface::markChanged();
 
 	// defer actual update of screen until SDL_Flip()
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, const_cast<SDL_Color *>(colors), firstcolor, ncolors) == 0)
@@ -328,6 +333,7 @@ void Screen::resetDisplay(bool resetVideo, bool noShaders)
 	Uint32 oldFlags = _flags;
 #endif
 	makeVideoFlags();
+	Surface::markChanged();
 
 	if (!_surface || (_surface->format->BitsPerPixel != _bpp ||
 		_surface->w != _baseWidth ||
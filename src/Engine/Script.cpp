@@ -24,9 +24,15 @@
 #include <cmath>
 #include <bitset>
 #include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <iterator>
 
 #include "Logger.h"
 #include "Options.h"
+#include "CrossPlatform.h"
 #include "Script.h"
 #include "ScriptBind.h"
 #include "Surface.h"
@@ -35,6 +41,9 @@
 #include "Exception.h"
 #include "../fallthrough.h"
 #include "Collections.h"
+#include "Profiler.h"
+#include "../md5.h"
+#include "../version.h"
 
 namespace OpenXcom
 {
@@ -231,6 +240,16 @@ static inline RetEnum bit_popcount_h(int& reg)
 	\
 	IMPL(call,			MACRO_QUOTE({ return call_func_h(c, func, d, p);								}),		(ScriptFunc func, const Uint8* d, ScriptWorkerBase& c, ProgPos& p),		"") \
 
+/**
+ * Operations that only the script optimizer puts into the bytecode.
+ * They have no name in the parser, so scripts can't use them.
+ * @param IMPL same as for MACRO_PROC_DEFINITION.
+ */
+#define MACRO_PROC_INTERNAL_DEFINITION(IMPL) \
+	/*	Name,		Implementation,													End execution,				Args,					Description */ \
+	IMPL(add_shade_exit,	MACRO_QUOTE({ addShade_h(Reg0, Data1);						return RetEnd;		}),		(int& Reg0, int Data1),		"") \
+
+
 
 ////////////////////////////////////////////////////////////
 //					function definition
@@ -256,6 +275,7 @@ namespace
 	};
 
 MACRO_PROC_DEFINITION(MACRO_CREATE_FUNC)
+MACRO_PROC_INTERNAL_DEFINITION(MACRO_CREATE_FUNC)
 
 #undef MACRO_CREATE_FUNC
 
@@ -371,6 +391,7 @@ struct Func_test_eq_text
 enum ProcEnum : Uint8
 {
 	MACRO_PROC_DEFINITION(MACRO_CREATE_PROC_ENUM)
+	MACRO_PROC_INTERNAL_DEFINITION(MACRO_CREATE_PROC_ENUM)
 	Proc_EnumMax,
 };
 
@@ -383,11 +404,13 @@ enum ProcEnum : Uint8
 /**
  * Core function in script engine used to executing scripts
  * @param proc array storing operation of script
- * @return Result of executing script
+ * @return Number of executed operations when Count is set, otherwise zero.
  */
-static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
+template<bool Count>
+static inline Uint64 scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 {
 	ProgPos curr = ProgPos::Start;
+	Uint64 count = 0;
 	//--------------------------------------------------
 	//			helper macros for this function
 	//--------------------------------------------------
@@ -414,10 +437,14 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 		}
 	//--------------------------------------------------
 
-	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY) MACRO_PROC_INTERNAL_DEFINITION(MACRO_FUNC_ARRAY));
 
 	while (true)
 	{
+		if (Count)
+		{
+			++count;
+		}
 		switch (proc[(int)curr++])
 		{
 		MACRO_COPY_256(MACRO_FUNC_ARRAY_LOOP, 0)
@@ -439,20 +466,495 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 	}
 
 	endLabel:
-	return;
+	return count;
+}
+
+/**
+ * Get size of arguments that follow given operation in proc vector.
+ * @param procId Operation id.
+ * @return Size in bytes.
+ */
+static int getProcArgSize(Uint8 procId)
+{
+	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
+	#define MACRO_FUNC_ARRAY_LOOP(POS) \
+		case (POS): return helper::GetType<func, POS>::offset;
+
+	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY) MACRO_PROC_INTERNAL_DEFINITION(MACRO_FUNC_ARRAY));
+
+	switch (procId)
+	{
+	MACRO_COPY_256(MACRO_FUNC_ARRAY_LOOP, 0)
+	}
+
+	#undef MACRO_FUNC_ARRAY_LOOP
+	#undef MACRO_FUNC_ARRAY
+
+	return 0;
+}
+
+/**
+ * Peephole pass over finished script, simplify jumps created by `if`, `else`, `loop` and `break`.
+ * Every change keep operation at same position, this mean all labels stay valid and rest of removed operation is dead code.
+ *
+ * First pass fold constants: values of int registers set by `set`, `clear`, `add` and `sub` are tracked until next operation
+ * that could change them or next jump target, `add` and `sub` of known value become `set`, and test of known values become `goto`,
+ * what remove dead branch. Second pass thread jumps and fuse `add_shade` followed by `exit`, used by every item recolor script.
+ * @param proc Proc vector of script.
+ * @param procEnd Position after last operation.
+ * @param jumpTargets Positions that any label point to.
+ */
+static void optimizeProc(std::vector<Uint8>& proc, ProgPos procEnd, const std::vector<bool>& jumpTargets)
+{
+	using GroupSet = helper::FuncGroup<MACRO_FUNC_ID(set)>;
+	using GroupAdd = helper::FuncGroup<MACRO_FUNC_ID(add)>;
+	using GroupSub = helper::FuncGroup<MACRO_FUNC_ID(sub)>;
+	// `test_le` and `test_eq` have same arguments, layout of both is read using `GroupTest`
+	using GroupTest = helper::FuncGroup<MACRO_FUNC_ID(test_le)>;
+
+	static_assert(helper::FuncVer<MACRO_FUNC_ID(goto), 0>::offset == sizeof(ProgPos), "Invalid goto layout");
+	static_assert(helper::FuncGroup<MACRO_FUNC_ID(goto)>::ver() == 1, "Invalid goto overloads");
+	static_assert(helper::FuncVer<MACRO_FUNC_ID(test_le), 0>::offset >= sizeof(ProgPos), "Invalid test layout");
+	static_assert(std::is_same<decltype(MACRO_FUNC_ID(test_le)::func), decltype(MACRO_FUNC_ID(test_eq)::func)>::value, "Invalid test layout");
+	// version of `int` argument, see `ArgSelector<ScriptInt>`
+	constexpr int argReg = 0;
+	constexpr int argConst = 1;
+	static_assert(helper::ArgSelector<ScriptInt>::type::offset(argReg) == sizeof(Uint8), "Invalid int arg layout");
+	static_assert(helper::ArgSelector<ScriptInt>::type::offset(argConst) == sizeof(ScriptInt), "Invalid int arg layout");
+
+	static_assert(helper::FuncVer<MACRO_FUNC_ID(add), argConst>::offset == helper::FuncVer<MACRO_FUNC_ID(set), argConst>::offset, "Invalid add layout");
+	static_assert(helper::FuncVer<MACRO_FUNC_ID(sub), argConst>::offset == helper::FuncVer<MACRO_FUNC_ID(set), argConst>::offset, "Invalid sub layout");
+	static_assert(GroupSet::offset(argConst, 1) == GroupAdd::offset(argConst, 0) && GroupSet::offset(argConst, 2) == GroupAdd::offset(argConst, 1), "Invalid add layout");
+	static_assert(GroupSet::offset(argConst, 1) == GroupSub::offset(argConst, 0) && GroupSet::offset(argConst, 2) == GroupSub::offset(argConst, 1), "Invalid sub layout");
+	static_assert(helper::FuncGroup<MACRO_FUNC_ID(add_shade)>::ver() == helper::FuncGroup<MACRO_FUNC_ID(add_shade_exit)>::ver(), "Invalid add_shade_exit overloads");
+
+	constexpr int maxChain = 16;
+	const auto end = static_cast<size_t>(procEnd);
+
+	auto readLabel = [&](size_t pos)
+	{
+		ProgPos label;
+		memcpy(&label, &proc[pos], sizeof(ProgPos));
+		return label;
+	};
+	auto writeLabel = [&](size_t pos, ProgPos label)
+	{
+		memcpy(&proc[pos], &label, sizeof(ProgPos));
+	};
+	auto isTest = [](Uint8 procId)
+	{
+		return (Proc_test_le <= procId && procId <= Proc_test_le_end) || (Proc_test_eq <= procId && procId <= Proc_test_eq_end);
+	};
+	auto isJumpTarget = [&](size_t pos)
+	{
+		return pos < jumpTargets.size() && jumpTargets[pos];
+	};
+
+	// values of int registers known at current position
+	std::bitset<256> known;
+	int values[256] = { };
+
+	// read int argument that is constant or register with known value
+	auto readInt = [&](size_t pos, bool isReg, int& value)
+	{
+		if (isReg)
+		{
+			if (!known[proc[pos]])
+			{
+				return false;
+			}
+			value = values[proc[pos]];
+		}
+		else
+		{
+			memcpy(&value, &proc[pos], sizeof(int));
+		}
+		return true;
+	};
+	auto writeInt = [&](size_t pos, int value)
+	{
+		memcpy(&proc[pos], &value, sizeof(int));
+	};
+	// same as `Reg0 += Data1` or `Reg0 -= Data1` but without overflow
+	auto addWrap = [](int a, int b, bool isAdd)
+	{
+		return static_cast<int>(isAdd ? static_cast<unsigned>(a) + static_cast<unsigned>(b) : static_cast<unsigned>(a) - static_cast<unsigned>(b));
+	};
+
+	// positions of operations before any change, replaced operation can be shorter than original one
+	std::vector<size_t> procPos;
+
+	size_t curr = static_cast<size_t>(ProgPos::Start);
+	while (curr < end)
+	{
+		const auto procId = proc[curr];
+		const auto next = curr + 1 + getProcArgSize(procId);
+		const auto args = curr + 1;
+
+		procPos.push_back(curr);
+		if (isJumpTarget(curr))
+		{
+			known.reset();
+		}
+
+		if (Proc_set <= procId && procId <= Proc_set_end)
+		{
+			const int ver = procId - Proc_set;
+			const auto reg = proc[args + GroupSet::offset(ver, 1)];
+			int value = 0;
+			known[reg] = readInt(args + GroupSet::offset(ver, 2), GroupSet::pos(ver, 2) == argReg, value);
+			values[reg] = value;
+		}
+		else if (Proc_clear <= procId && procId <= Proc_clear_end)
+		{
+			const auto reg = proc[args + helper::FuncGroup<MACRO_FUNC_ID(clear)>::offset(0, 1)];
+			known[reg] = true;
+			values[reg] = 0;
+		}
+		else if ((Proc_add <= procId && procId <= Proc_add_end) || (Proc_sub <= procId && procId <= Proc_sub_end))
+		{
+			const bool isAdd = procId <= Proc_add_end;
+			const int ver = procId - (isAdd ? Proc_add : Proc_sub);
+			const auto reg = proc[args + GroupAdd::offset(ver, 0)];
+			int value = 0;
+			if (known[reg] && readInt(args + GroupAdd::offset(ver, 1), GroupAdd::pos(ver, 1) == argReg, value))
+			{
+				values[reg] = addWrap(values[reg], value, isAdd);
+				if (GroupAdd::pos(ver, 1) == argConst)
+				{
+					// same layout as `set reg const`
+					proc[curr] = Proc_set + ver;
+					writeInt(args + GroupSet::offset(argConst, 2), values[reg]);
+				}
+			}
+			else
+			{
+				known[reg] = false;
+			}
+		}
+		else if (isTest(procId))
+		{
+			const bool isLe = procId <= Proc_test_le_end;
+			const int ver = procId - (isLe ? Proc_test_le : Proc_test_eq);
+			int a = 0, b = 0;
+			const bool knownA = readInt(args + GroupTest::offset(ver, 1), GroupTest::pos(ver, 1) == argReg, a);
+			const bool knownB = readInt(args + GroupTest::offset(ver, 2), GroupTest::pos(ver, 2) == argReg, b);
+			const bool sameReg = GroupTest::pos(ver, 1) == argReg && GroupTest::pos(ver, 2) == argReg && proc[args + GroupTest::offset(ver, 1)] == proc[args + GroupTest::offset(ver, 2)];
+			if ((knownA && knownB) || sameReg)
+			{
+				// result is always same, other branch is dead
+				const bool result = sameReg || (isLe ? a <= b : a == b);
+				const auto label = readLabel(args + GroupTest::offset(ver, result ? 3 : 4));
+				proc[curr] = Proc_goto;
+				writeLabel(args, label);
+			}
+		}
+		else if (procId != Proc_goto)
+		{
+			// any other operation can change any register
+			known.reset();
+		}
+
+		curr = next;
+	}
+
+	// jump directly to final target of chain of `goto`
+	auto threadLabel = [&](size_t pos)
+	{
+		auto label = readLabel(pos);
+		for (int i = 0; i < maxChain && static_cast<size_t>(label) < end && proc[static_cast<size_t>(label)] == Proc_goto; ++i)
+		{
+			label = readLabel(static_cast<size_t>(label) + 1);
+		}
+		writeLabel(pos, label);
+		return label;
+	};
+
+	for (size_t i = 0; i < procPos.size(); ++i)
+	{
+		curr = procPos[i];
+		const auto procId = proc[curr];
+		const auto next = i + 1 < procPos.size() ? procPos[i + 1] : end;
+
+		if (procId == Proc_goto)
+		{
+			auto label = static_cast<size_t>(threadLabel(curr + 1));
+			if (label < end && proc[label] == Proc_exit)
+			{
+				proc[curr] = Proc_exit;
+			}
+		}
+		else if (isTest(procId))
+		{
+			auto labelTrue = threadLabel(next - 2 * sizeof(ProgPos));
+			auto labelFalse = threadLabel(next - 1 * sizeof(ProgPos));
+			if (labelTrue == labelFalse)
+			{
+				// both branches go to same place, condition do not matter
+				proc[curr] = Proc_goto;
+				writeLabel(curr + 1, labelTrue);
+			}
+		}
+
+		if (proc[curr] == Proc_exit && i > 0 && Proc_add_shade <= proc[procPos[i - 1]] && proc[procPos[i - 1]] <= Proc_add_shade_end)
+		{
+			// `exit` stay in place for jumps that target it
+			proc[procPos[i - 1]] = Proc_add_shade_exit + (proc[procPos[i - 1]] - Proc_add_shade);
+		}
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+//					ScriptProfiler
+////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/**
+ * Collected cost of one script.
+ */
+struct ScriptProfileData
+{
+	std::string hook;
+	std::string mod;
+	std::string parent;
+	Uint64 calls = 0;
+	Uint64 totalTime = 0;
+	Uint64 maxTime = 0;
+	Uint64 operations = 0;
+
+	/// Add cost of other script.
+	void add(const ScriptProfileData& d)
+	{
+		calls += d.calls;
+		totalTime += d.totalTime;
+		maxTime = std::max(maxTime, d.maxTime);
+		operations += d.operations;
+	}
+};
+
+std::mutex scriptProfileMutex;
+std::unordered_map<const Uint8*, ScriptProfileData> scriptProfile;
+
+/**
+ * Start collecting cost of new script.
+ * @param proc Proc data of script, used to identify it during execution.
+ */
+void scriptProfileAdd(const Uint8* proc, const std::string& hook, const std::string& mod, const std::string& parent)
+{
+	std::lock_guard<std::mutex> lock(scriptProfileMutex);
+	auto& d = scriptProfile[proc];
+	d = ScriptProfileData{};
+	d.hook = hook;
+	d.mod = mod;
+	d.parent = parent;
 }
 
+/**
+ * Execute script and add its time and number of operations to its statistics.
+ */
+[[gnu::noinline]]
+void scriptExeProfile(ScriptWorkerBase& data, const Uint8* proc)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto operations = scriptExe<true>(data, proc);
+	Uint64 time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::lock_guard<std::mutex> lock(scriptProfileMutex);
+	auto it = scriptProfile.find(proc);
+	if (it != scriptProfile.end())
+	{
+		auto& d = it->second;
+		d.calls += 1;
+		d.totalTime += time;
+		d.maxTime = std::max(d.maxTime, time);
+		d.operations += operations;
+	}
+}
+
+/**
+ * Execute script, with statistics if profiler is enabled.
+ */
+inline void runScript(ScriptWorkerBase& data, const Uint8* proc)
+{
+	if (Options::oxceScriptProfiler)
+	{
+		scriptExeProfile(data, proc);
+	}
+	else
+	{
+		scriptExe<false>(data, proc);
+	}
+}
+
+} //namespace
+
+namespace ScriptProfiler
+{
+
+/**
+ * Log collected statistics, each script and sums for each hook and each mod, most expensive first.
+ * Times are in microseconds.
+ * @param reason What triggered the dump, shown in the log.
+ */
+void dump(const std::string& reason)
+{
+	if (!Options::oxceScriptProfiler)
+	{
+		return;
+	}
+
+	std::vector<ScriptProfileData> scripts;
+	std::map<std::string, ScriptProfileData> hooks;
+	std::map<std::string, ScriptProfileData> mods;
+	{
+		std::lock_guard<std::mutex> lock(scriptProfileMutex);
+		for (const auto& p : scriptProfile)
+		{
+			if (p.second.calls)
+			{
+				scripts.push_back(p.second);
+				hooks[p.second.hook].add(p.second);
+				mods[p.second.mod].add(p.second);
+			}
+		}
+	}
+
+	auto byTime = [](const ScriptProfileData& a, const ScriptProfileData& b) { return a.totalTime > b.totalTime; };
+	auto logLine = [](const std::string& name, const ScriptProfileData& d)
+	{
+		Log(LOG_INFO) << std::left << std::setw(60) << name << std::right
+			<< " calls: " << std::setw(10) << d.calls
+			<< " total: " << std::setw(10) << d.totalTime / 1000
+			<< " max: " << std::setw(8) << d.maxTime / 1000
+			<< " ops: " << std::setw(12) << d.operations;
+	};
+	auto logSums = [&](const char* title, const std::map<std::string, ScriptProfileData>& sums)
+	{
+		std::vector<std::pair<std::string, ScriptProfileData>> sorted(sums.begin(), sums.end());
+		std::sort(sorted.begin(), sorted.end(), [&](const auto& a, const auto& b) { return byTime(a.second, b.second); });
+		Log(LOG_INFO) << title;
+		for (const auto& p : sorted)
+		{
+			logLine(p.first, p.second);
+		}
+	};
+
+	std::sort(scripts.begin(), scripts.end(), byTime);
+
+	Log(LOG_INFO) << "Script profile (" << reason << "), times in microseconds:";
+	logSums("Per hook:", hooks);
+	logSums("Per mod:", mods);
+	Log(LOG_INFO) << "Per script:";
+	for (const auto& d : scripts)
+	{
+		logLine(d.hook + " " + d.mod + " " + d.parent, d);
+	}
+}
+
+/**
+ * Forget collected statistics, scripts stay registered.
+ */
+void reset()
+{
+	std::lock_guard<std::mutex> lock(scriptProfileMutex);
+	for (auto& p : scriptProfile)
+	{
+		auto& d = p.second;
+		d.calls = 0;
+		d.totalTime = 0;
+		d.maxTime = 0;
+		d.operations = 0;
+	}
+}
+
+}
 
 ////////////////////////////////////////////////////////////
 //						Script class
 ////////////////////////////////////////////////////////////
 
+/**
+ * Check if any of the scripts reads or writes the destination pixel.
+ * @param proc main script.
+ * @param events event scripts, before and after the main one.
+ * @return True if the result could depend on destination surface.
+ */
+bool ScriptWorkerBlit::isDestUsed(const ScriptContainerBase& proc, const ScriptContainerBase* events)
+{
+	constexpr size_t destReg = offsetOutputReg(helper::TypeTag<Output>{}, 1);
+	if (proc.isRegUsed(destReg))
+	{
+		return true;
+	}
+	if (events)
+	{
+		for (int i = 0; i < 2; ++i)
+		{
+			while (*events)
+			{
+				if (events->isRegUsed(destReg))
+				{
+					return true;
+				}
+				++events;
+			}
+			++events;
+		}
+	}
+	return false;
+}
+
+/**
+ * Run scripts for one pixel.
+ * @param src source pixel.
+ * @param dest destination pixel.
+ * @return New value of destination pixel, 0 to leave it unchanged.
+ */
+int ScriptWorkerBlit::executePixel(Uint8 src, Uint8 dest)
+{
+	ScriptWorkerBlit::Output arg = { src, dest };
+	set(arg);
+	if (_events)
+	{
+		auto ptr = _events;
+		while (*ptr)
+		{
+			reset(arg);
+			runScript(*this, ptr->data());
+			++ptr;
+		}
+		++ptr;
+
+		reset(arg);
+		runScript(*this, _proc);
+
+		while (*ptr)
+		{
+			reset(arg);
+			runScript(*this, ptr->data());
+			++ptr;
+		}
+	}
+	else
+	{
+		runScript(*this, _proc);
+	}
+	get(arg);
+	return arg.getFirst();
+}
+
 void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int y, int shade)
 {
 	executeBlit(src, dest, x, y, shade, GraphSubset{ dest->getWidth(), dest->getHeight() } );
 }
 /**
  * Blitting one surface to another using script.
+ * Scripts that don't use the destination pixel give the same result for every
+ * pixel of a given color, so they are run only once for each color in the sprite.
+ * Other scripts are run once for each pair of source and destination colors.
  * @param src source surface.
  * @param dest destination surface.
  * @param x x offset of source surface.
@@ -467,37 +969,21 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 
 	if (_proc)
 	{
-		if (_events)
+		if (_sourceOnly)
 		{
+			int colors[256];
+			bool known[256] = { };
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						auto ptr = _events;
-						while (*ptr)
+						if (!known[srcStuff])
 						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
+							known[srcStuff] = true;
+							colors[srcStuff] = executePixel(srcStuff, destStuff);
 						}
-						++ptr;
-
-						reset(arg);
-						scriptExe(*this, _proc);
-
-						while (*ptr)
-						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
-						}
-						++ptr;
-
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						if (colors[srcStuff]) destStuff = colors[srcStuff];
 					}
 				},
 				destShader,
@@ -506,16 +992,23 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 		}
 		else
 		{
+			// final pixel for each pair of source and destination colors already seen
+			static thread_local Uint8 pairs[256 * 256];
+			static thread_local std::bitset<256 * 256> known;
+			known.reset();
 			ShaderDrawFunc(
 				[&](Uint8& destStuff, const Uint8& srcStuff)
 				{
 					if (srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						scriptExe(*this, _proc);
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
+						const int key = (srcStuff << 8) | destStuff;
+						if (!known[key])
+						{
+							known[key] = true;
+							int color = executePixel(srcStuff, destStuff);
+							pairs[key] = color ? color : destStuff;
+						}
+						destStuff = pairs[key];
 					}
 				},
 				destShader,
@@ -537,7 +1030,7 @@ void ScriptWorkerBase::executeBase(const Uint8* proc)
 {
 	if (proc)
 	{
-		scriptExe(*this, proc);
+		runScript(*this, proc);
 	}
 }
 
@@ -1344,7 +1837,7 @@ bool parseCustomProc(const ScriptProcData& spd, ParserWriter& ph, const ScriptRe
 	}
 
 	auto argPosEnd = ph.getCurrPos();
-	ph.updateReserved<ScriptFunc>(funcPos, spd.parserGet(argType));
+	ph.updateReservedFunc(funcPos, spd, argType);
 
 	size_t diff = ph.getDiffPos(argPosBegin, argPosEnd);
 	for (int i = 0; i < argRaw::ver(); ++i)
@@ -2214,6 +2707,17 @@ void ParserWriter::relese()
 			updateReserved<ProgPos>(pos, value);
 		}
 	);
+	if (Options::oxceScriptOptimize)
+	{
+		std::vector<bool> jumpTargets(container._proc.size() + 1);
+		refLabels.forEachPosition(
+			[&](auto pos, ProgPos value)
+			{
+				jumpTargets[static_cast<size_t>(value)] = true;
+			}
+		);
+		optimizeProc(container._proc, getCurrPos(), jumpTargets);
+	}
 
 	auto textTotalSize = 0u;
 	refTexts.forEachPosition(
@@ -2271,6 +2775,7 @@ void ParserWriter::relese()
 			++currentText;
 
 			updateReserved<ScriptText>(pos, ScriptText{ charPtr(start) });
+			relocations.push_back(Relocation{ Relocation::Text, pos.getPos(), nullptr, static_cast<size_t>(start), {} });
 		}
 	);
 }
@@ -2464,6 +2969,10 @@ bool ParserWriter::pushConstTry(const ScriptRefData& data, ArgEnum type)
 {
 	if (data && data.type == type && !ArgIsReg(data.type) && data.value.type == type)
 	{
+		if (ArgIsPtr(type))
+		{
+			relocations.push_back(Relocation{ Relocation::Const, getCurrPos(), nullptr, 0, data.name });
+		}
 		pushValue(data.value);
 		return true;
 	}
@@ -2480,6 +2989,7 @@ bool ParserWriter::pushRegTry(const ScriptRefData& data, ArgEnum type)
 	type = ArgSpecAdd(type, ArgSpecReg);
 	if (data && ArgCompatible(type, data.type, 0) && data.getValue<RegEnum>() != RegInvalid)
 	{
+		container._regUsed.set(data.getValue<RegEnum>());
 		pushValue(static_cast<Uint8>(data.getValue<RegEnum>()));
 		return true;
 	}
@@ -2580,7 +3090,8 @@ ScriptParserBase::ScriptParserBase(ScriptGlobal* shared, const std::string& name
 	_emptyReturn{ false },
 	_regUsedSpace{ RegStartPos },
 	_regOutSize{ 0 }, _regOutName{ },
-	_name{ name }
+	_name{ name },
+	_refVersion{ 0 }, _refHashVersion{ (size_t)-1 }
 {
 	//--------------------------------------------------
 	//					op_data init
@@ -2689,6 +3200,7 @@ ScriptRef ScriptParserBase::addNameRef(const std::string& s)
  */
 void ScriptParserBase::addParserBase(const std::string& s, const std::string& description, ScriptProcData::overloadFunc overload, ScriptRange<ScriptRange<ArgEnum>> overloadArg, ScriptProcData::parserFunc parser, ScriptProcData::argFunc arg, ScriptProcData::getFunc get)
 {
+	++_refVersion;
 	if (haveNameRef(s))
 	{
 		auto procs = getProc(ScriptRef{ s.data(), s.data() + s.size() });
@@ -2716,6 +3228,7 @@ void ScriptParserBase::addParserBase(const std::string& s, const std::string& de
  */
 void ScriptParserBase::addTypeBase(const std::string& s, ArgEnum type, TypeInfo meta)
 {
+	++_refVersion;
 	if (haveNameRef(s))
 	{
 		throw Exception("Type name '" + s + "' already used");
@@ -2748,6 +3261,7 @@ bool ScriptParserBase::haveTypeBase(ArgEnum type)
  */
 void ScriptParserBase::addScriptReg(const std::string& s, ArgEnum type, bool writableReg, bool outputReg)
 {
+	++_refVersion;
 	if (writableReg || outputReg)
 	{
 		if (outputReg && _regOutSize >= ScriptMaxOut)
@@ -2799,6 +3313,7 @@ void ScriptParserBase::addScriptReg(const std::string& s, ArgEnum type, bool wri
  */
 void ScriptParserBase::addConst(const std::string& s, ScriptValueData i)
 {
+	++_refVersion;
 	if (haveNameRef(s))
 	{
 		throw Exception("Const name '" + s + "' already used");
@@ -2814,6 +3329,7 @@ void ScriptParserBase::addConst(const std::string& s, ScriptValueData i)
  */
 void ScriptParserBase::updateConst(const std::string& s, ScriptValueData i)
 {
+	++_refVersion;
 	ScriptRefData* f = findSortHelper(_refList, ScriptRef{ s.data(), s.data() + s.size() });
 	if (!f)
 	{
@@ -2923,6 +3439,429 @@ const ScriptRefData* ScriptParserBase::getRef(ScriptRef prefix, ScriptRef postfi
 	return findSortHelper(_refList, prefix, postfix);
 }
 
+////////////////////////////////////////////////////////////
+//					compiled script cache
+////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const char ScriptCacheHeader[] = "oxce-script-cache-1";
+
+/**
+ * Compiled script stored on disk, with places that need pointers of current run.
+ */
+struct ScriptCacheEntry
+{
+	struct Relocation
+	{
+		Uint8 kind;
+		Uint32 pos;
+		Uint32 index;
+		Uint32 value;
+		std::string name;
+	};
+
+	std::vector<Uint8> proc;
+	std::vector<Uint8> regUsed;
+	std::vector<Relocation> relocations;
+	bool used = false;
+};
+
+std::unordered_map<std::string, ScriptCacheEntry> scriptCache;
+bool scriptCacheLoaded = false;
+bool scriptCacheDirty = false;
+
+std::string getScriptCacheFile() { return Options::getCacheFolder() + "scripts.dat"; }
+
+/**
+ * Is cache of compiled scripts available?
+ */
+bool isScriptCacheEnabled()
+{
+	return Options::oxceDiskCache && CrossPlatform::folderExists(Options::getCacheFolder());
+}
+
+void hashValue(MD5& hash, const void* data, size_t size)
+{
+	hash.update(static_cast<const unsigned char*>(data), static_cast<MD5::size_type>(size));
+}
+
+void hashRef(MD5& hash, ScriptRef ref)
+{
+	const Uint32 size = ref.size();
+	hashValue(hash, &size, sizeof(size));
+	hashValue(hash, ref.begin(), size);
+}
+
+/**
+ * Add name, type and value of refs to hash, values of pointers are different in each run and are skipped.
+ */
+void hashRefList(MD5& hash, const std::vector<ScriptRefData>& refList)
+{
+	for (const auto& r : refList)
+	{
+		hashRef(hash, r.name);
+		hashValue(hash, &r.type, sizeof(r.type));
+		if (!ArgIsPtr(r.value.type))
+		{
+			hashValue(hash, &r.value.type, sizeof(r.value.type));
+			hashValue(hash, &r.value.data, r.value.size);
+		}
+	}
+}
+
+/**
+ * Read binary data from cache file.
+ */
+struct ScriptCacheReader
+{
+	const std::string& data;
+	size_t pos;
+	bool ok;
+
+	template<typename T>
+	T get()
+	{
+		T t = { };
+		if (pos + sizeof(T) > data.size())
+		{
+			ok = false;
+			return t;
+		}
+		memcpy(&t, &data[pos], sizeof(T));
+		pos += sizeof(T);
+		return t;
+	}
+	template<typename T>
+	void get(std::vector<T>& v, size_t size)
+	{
+		if (pos + size * sizeof(T) > data.size())
+		{
+			ok = false;
+			return;
+		}
+		v.resize(size);
+		memcpy(v.data(), &data[pos], size * sizeof(T));
+		pos += size * sizeof(T);
+	}
+	std::string getString()
+	{
+		auto size = get<Uint32>();
+		if (!ok || pos + size > data.size())
+		{
+			ok = false;
+			return {};
+		}
+		pos += size;
+		return data.substr(pos - size, size);
+	}
+};
+
+/**
+ * Loads the cache of compiled scripts from disk, once per run.
+ * Any inconsistency just drops the whole cache.
+ */
+void loadScriptCache()
+{
+	if (scriptCacheLoaded)
+	{
+		return;
+	}
+	scriptCacheLoaded = true;
+
+	auto filename = getScriptCacheFile();
+	if (!CrossPlatform::fileExists(filename))
+	{
+		return;
+	}
+	std::string data;
+	try
+	{
+		auto in = CrossPlatform::readFile(filename);
+		data.assign(std::istreambuf_iterator<char>(*in), std::istreambuf_iterator<char>());
+	}
+	catch (Exception &)
+	{
+		return;
+	}
+
+	ScriptCacheReader r{ data, 0, true };
+	if (r.getString() != ScriptCacheHeader)
+	{
+		return;
+	}
+	auto count = r.get<Uint32>();
+	for (Uint32 i = 0; i < count && r.ok; ++i)
+	{
+		auto key = r.getString();
+		ScriptCacheEntry entry;
+		r.get(entry.proc, r.get<Uint32>());
+		r.get(entry.regUsed, r.get<Uint32>());
+		auto relocations = r.get<Uint32>();
+		for (Uint32 j = 0; j < relocations && r.ok; ++j)
+		{
+			ScriptCacheEntry::Relocation rel;
+			rel.kind = r.get<Uint8>();
+			rel.pos = r.get<Uint32>();
+			rel.index = r.get<Uint32>();
+			rel.value = r.get<Uint32>();
+			rel.name = r.getString();
+			entry.relocations.push_back(std::move(rel));
+		}
+		scriptCache[key] = std::move(entry);
+	}
+	if (!r.ok || r.pos != data.size())
+	{
+		Log(LOG_WARNING) << "Ignoring corrupt script cache " << filename;
+		scriptCache.clear();
+	}
+}
+
+/**
+ * Writes the cache of compiled scripts out if anything changed,
+ * dropping scripts that were not used in this run.
+ */
+void saveScriptCache()
+{
+	if (!scriptCacheLoaded)
+	{
+		return;
+	}
+	for (auto it = scriptCache.begin(); it != scriptCache.end(); )
+	{
+		if (!it->second.used)
+		{
+			it = scriptCache.erase(it);
+			scriptCacheDirty = true;
+		}
+		else
+		{
+			it->second.used = false;
+			++it;
+		}
+	}
+	if (!scriptCacheDirty || !isScriptCacheEnabled())
+	{
+		return;
+	}
+	scriptCacheDirty = false;
+
+	std::vector<unsigned char> out;
+	auto put = [&](const void* data, size_t size)
+	{
+		out.insert(out.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+	};
+	auto put32 = [&](Uint32 v)
+	{
+		put(&v, sizeof(v));
+	};
+	auto putString = [&](const std::string& s)
+	{
+		put32(s.size());
+		put(s.data(), s.size());
+	};
+
+	putString(ScriptCacheHeader);
+	put32(scriptCache.size());
+	for (const auto& p : scriptCache)
+	{
+		const auto& entry = p.second;
+		putString(p.first);
+		put32(entry.proc.size());
+		put(entry.proc.data(), entry.proc.size());
+		put32(entry.regUsed.size());
+		put(entry.regUsed.data(), entry.regUsed.size());
+		put32(entry.relocations.size());
+		for (const auto& rel : entry.relocations)
+		{
+			put(&rel.kind, sizeof(rel.kind));
+			put32(rel.pos);
+			put32(rel.index);
+			put32(rel.value);
+			putString(rel.name);
+		}
+	}
+	CrossPlatform::writeFile(getScriptCacheFile(), out);
+}
+
+} //namespace
+
+/**
+ * Get key of compiled script in cache, made from the engine version, all names visible to script and its source.
+ * @param srcCode Source of script.
+ * @return Key or empty string if cache is disabled.
+ */
+std::string ScriptParserBase::getCacheKey(const std::string& srcCode) const
+{
+	if (!isScriptCacheEnabled())
+	{
+		return {};
+	}
+	loadScriptCache();
+
+	if (_refHashVersion != _refVersion)
+	{
+		MD5 hash;
+		hashValue(hash, _name.data(), _name.size());
+		hashValue(hash, &_regUsedSpace, sizeof(_regUsedSpace));
+		hashValue(hash, &_regOutSize, sizeof(_regOutSize));
+		hashValue(hash, &_emptyReturn, sizeof(_emptyReturn));
+		for (const auto& t : _typeList)
+		{
+			hashRef(hash, t.name);
+			hashValue(hash, &t.type, sizeof(t.type));
+			hashValue(hash, &t.meta, sizeof(t.meta));
+		}
+		for (const auto& p : _procList)
+		{
+			hashRef(hash, p.name);
+			for (const auto& o : p.overloadArg)
+			{
+				const Uint32 size = o.size();
+				hashValue(hash, &size, sizeof(size));
+				hashValue(hash, o.begin(), size * sizeof(ArgEnum));
+			}
+		}
+		hashRefList(hash, _refList);
+		_refHash = hash.finalize().hexdigest();
+		_refHashVersion = _refVersion;
+	}
+
+	const char version[] = OPENXCOM_VERSION_SHORT OPENXCOM_VERSION_GIT " " __DATE__ " " __TIME__;
+	const Uint8 optimize = Options::oxceScriptOptimize;
+	const Uint8 pointerSize = sizeof(void*);
+
+	MD5 hash;
+	hashValue(hash, ScriptCacheHeader, sizeof(ScriptCacheHeader));
+	hashValue(hash, version, sizeof(version));
+	hashValue(hash, &optimize, sizeof(optimize));
+	hashValue(hash, &pointerSize, sizeof(pointerSize));
+	hashValue(hash, _refHash.data(), _refHash.size());
+	hashValue(hash, _shared->getRefHash().data(), _shared->getRefHash().size());
+	hashValue(hash, srcCode.data(), srcCode.size());
+	return hash.finalize().hexdigest();
+}
+
+/**
+ * Try loading compiled script from cache, pointers in it are updated to values in current run.
+ * @param key Key of script.
+ * @param destScript Container for script.
+ * @return True if script was loaded.
+ */
+bool ScriptParserBase::loadCache(const std::string& key, ScriptContainerBase& destScript) const
+{
+	auto it = scriptCache.find(key);
+	if (it == scriptCache.end())
+	{
+		return false;
+	}
+	auto& entry = it->second;
+
+	ScriptContainerBase tempScript;
+	tempScript._proc = entry.proc;
+	for (size_t i = 0; i < tempScript._regUsed.size() && i / 8 < entry.regUsed.size(); ++i)
+	{
+		tempScript._regUsed[i] = (entry.regUsed[i / 8] >> (i % 8)) & 1;
+	}
+
+	auto& proc = tempScript._proc;
+	auto write = [&](size_t pos, const void* data, size_t size)
+	{
+		if (pos + size > proc.size())
+		{
+			return false;
+		}
+		memcpy(&proc[pos], data, size);
+		return true;
+	};
+	for (const auto& rel : entry.relocations)
+	{
+		bool ok = false;
+		switch (rel.kind)
+		{
+		case ParserWriter::Relocation::Func:
+			if (rel.index < _procList.size() && _procList[rel.index].parserGet)
+			{
+				ScriptFunc func = _procList[rel.index].parserGet(rel.value);
+				ok = write(rel.pos, &func, sizeof(func));
+			}
+			break;
+		case ParserWriter::Relocation::Text:
+			if (rel.value < proc.size())
+			{
+				ScriptText text = { reinterpret_cast<const char*>(&proc[rel.value]) };
+				ok = write(rel.pos, &text, sizeof(text));
+			}
+			break;
+		case ParserWriter::Relocation::Const:
+			{
+				auto name = ScriptRef::tempFrom(rel.name);
+				auto ref = getRef(name);
+				if (ref == nullptr)
+				{
+					ref = _shared->getRef(name);
+				}
+				if (ref && ArgIsPtr(ref->value.type))
+				{
+					ok = write(rel.pos, &ref->value.data, ref->value.size);
+				}
+			}
+			break;
+		}
+		if (!ok)
+		{
+			return false;
+		}
+	}
+
+	entry.used = true;
+	destScript = std::move(tempScript);
+	return true;
+}
+
+/**
+ * Store compiled script in cache, pointers in it are replaced by data needed to restore them.
+ * @param key Key of script.
+ * @param srcScript Finished script.
+ * @param help Parser state that created the script.
+ */
+void ScriptParserBase::storeCache(const std::string& key, const ScriptContainerBase& srcScript, const ParserWriter& help) const
+{
+	ScriptCacheEntry entry;
+	entry.proc = srcScript._proc;
+	entry.regUsed.resize((srcScript._regUsed.size() + 7) / 8);
+	for (size_t i = 0; i < srcScript._regUsed.size(); ++i)
+	{
+		entry.regUsed[i / 8] |= srcScript._regUsed[i] << (i % 8);
+	}
+	for (const auto& rel : help.relocations)
+	{
+		ScriptCacheEntry::Relocation r = { };
+		r.kind = rel.kind;
+		r.pos = static_cast<Uint32>(rel.pos);
+		r.value = static_cast<Uint32>(rel.value);
+		if (rel.kind == ParserWriter::Relocation::Func)
+		{
+			r.index = static_cast<Uint32>(rel.proc - _procList.data());
+			memset(&entry.proc[r.pos], 0, sizeof(ScriptFunc));
+		}
+		else if (rel.kind == ParserWriter::Relocation::Text)
+		{
+			memset(&entry.proc[r.pos], 0, sizeof(ScriptText));
+		}
+		else
+		{
+			r.name = rel.name.toString();
+			memset(&entry.proc[r.pos], 0, sizeof(void*));
+		}
+		entry.relocations.push_back(std::move(r));
+	}
+	entry.used = true;
+	scriptCache[key] = std::move(entry);
+	scriptCacheDirty = true;
+}
+
 /**
  * Parse string and write script to ScriptBase
  * @param src struct where final script is write to
@@ -2931,6 +3870,17 @@ const ScriptRefData* ScriptParserBase::getRef(ScriptRef prefix, ScriptRef postfi
  */
 bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::string& parentName, const std::string& srcCode) const
 {
+	ProfilerScope profile("script", _name, parentName);
+	const auto cacheKey = getCacheKey(srcCode);
+	if (!cacheKey.empty() && loadCache(cacheKey, destScript))
+	{
+		if (Options::oxceScriptProfiler)
+		{
+			scriptProfileAdd(destScript.data(), _name, _shared->getCurrentMod(), parentName);
+		}
+		return true;
+	}
+
 	ScriptContainerBase tempScript;
 	std::string err = "Error in parsing script '" + _name + "' for '" + parentName + "': ";
 	ParserWriter help(
@@ -2971,7 +3921,15 @@ bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::str
 				return false;
 			}
 			help.relese();
+			if (!cacheKey.empty())
+			{
+				storeCache(cacheKey, tempScript, help);
+			}
 			destScript = std::move(tempScript);
+			if (Options::oxceScriptProfiler)
+			{
+				scriptProfileAdd(destScript.data(), _name, _shared->getCurrentMod(), parentName);
+			}
 			return true;
 		}
 
@@ -3495,11 +4453,11 @@ void ScriptValuesBase::setBase(size_t t, int i)
 {
 	if (t)
 	{
-		if (t > values.size())
+		if (t > _size)
 		{
-			values.resize(t);
+			resize(static_cast<Uint32>(t));
 		}
-		values[t - 1u] = i;
+		data()[t - 1u] = i;
 	}
 }
 
@@ -3508,13 +4466,106 @@ void ScriptValuesBase::setBase(size_t t, int i)
  */
 int ScriptValuesBase::getBase(size_t t) const
 {
-	if (t && t <= values.size())
+	if (t && t <= _size)
 	{
-		return values[t - 1u];
+		return data()[t - 1u];
 	}
 	return 0;
 }
 
+/**
+ * Change number of values, values are moved to heap when they do not fit in object.
+ * @param size New number of values.
+ */
+void ScriptValuesBase::resize(Uint32 size)
+{
+	if (size > _capacity)
+	{
+		auto capacity = std::max(size, _capacity * 2);
+		auto heap = new int[capacity]();
+		std::copy(data(), data() + _size, heap);
+		if (_capacity > InlineSize)
+		{
+			delete[] _heap;
+		}
+		_heap = heap;
+		_capacity = capacity;
+	}
+	else if (size > _size)
+	{
+		std::fill(data() + _size, data() + size, 0);
+	}
+	_size = size;
+}
+
+/**
+ * Copy constructor.
+ */
+ScriptValuesBase::ScriptValuesBase(const ScriptValuesBase& other) : ScriptValuesBase()
+{
+	*this = other;
+}
+
+/**
+ * Move constructor.
+ */
+ScriptValuesBase::ScriptValuesBase(ScriptValuesBase&& other) noexcept : ScriptValuesBase()
+{
+	*this = std::move(other);
+}
+
+/**
+ * Destructor.
+ */
+ScriptValuesBase::~ScriptValuesBase()
+{
+	if (_capacity > InlineSize)
+	{
+		delete[] _heap;
+	}
+}
+
+/**
+ * Copy.
+ */
+ScriptValuesBase& ScriptValuesBase::operator=(const ScriptValuesBase& other)
+{
+	if (this != &other)
+	{
+		_size = 0;
+		resize(other._size);
+		std::copy(other.data(), other.data() + other._size, data());
+	}
+	return *this;
+}
+
+/**
+ * Move.
+ */
+ScriptValuesBase& ScriptValuesBase::operator=(ScriptValuesBase&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (_capacity > InlineSize)
+		{
+			delete[] _heap;
+		}
+		if (other._capacity > InlineSize)
+		{
+			_heap = other._heap;
+		}
+		else
+		{
+			std::copy(other._inline, other._inline + InlineSize, _inline);
+		}
+		_size = other._size;
+		_capacity = other._capacity;
+		other._size = 0;
+		other._capacity = InlineSize;
+	}
+	return *this;
+}
+
 /**
  * Load values from yaml file.
  */
@@ -3526,7 +4577,8 @@ void ScriptValuesBase::loadBase(const YAML::Node &node, const ScriptGlobal* shar
 		{
 			for (const std::pair<YAML::Node, YAML::Node>& pair : tags)
 			{
-				size_t i = shared->getTag(type, ScriptRef::tempFrom("Tag." + pair.first.as<std::string>()));
+				const auto& name = pair.first.Scalar();
+				size_t i = shared->getTag(type, ScriptRef{ "Tag." }, ScriptRef::tempFrom(name));
 				if (i)
 				{
 					auto temp = 0;
@@ -3550,7 +4602,7 @@ void ScriptValuesBase::saveBase(YAML::Node &node, const ScriptGlobal* shared, Ar
 {
 	bool haveData = false;
 	YAML::Node tags;
-	for (size_t i = 1; i <= values.size(); ++i)
+	for (size_t i = 1; i <= _size; ++i)
 	{
 		if (int v = getBase(i))
 		{
@@ -3603,18 +4655,18 @@ ScriptGlobal::~ScriptGlobal()
 /**
  * Get tag value.
  */
-size_t ScriptGlobal::getTag(ArgEnum type, ScriptRef s) const
+size_t ScriptGlobal::getTag(ArgEnum type, ScriptRef prefix, ScriptRef postfix) const
 {
-	auto data = _tagNames.find(type);
-	if (data != _tagNames.end())
+	auto ref = findSortHelper(_refList, prefix, postfix);
+	if (ref && ref->type == type)
 	{
-		for (size_t i = 0; i < data->second.values.size(); ++i)
+		// value is `ScriptTag` with index of unsigned type of any size
+		switch (ref->value.size)
 		{
-			auto &name = data->second.values[i].name;
-			if (name == s)
-			{
-				return i + 1;
-			}
+		case sizeof(Uint8): { Uint8 i; memcpy(&i, &ref->value.data, sizeof(i)); return i; }
+		case sizeof(Uint16): { Uint16 i; memcpy(&i, &ref->value.data, sizeof(i)); return i; }
+		case sizeof(Uint32): { Uint32 i; memcpy(&i, &ref->value.data, sizeof(i)); return i; }
+		case sizeof(Uint64): { Uint64 i; memcpy(&i, &ref->value.data, sizeof(i)); return i; }
 		}
 	}
 	return 0;
@@ -3690,6 +4742,7 @@ size_t ScriptGlobal::addTag(ArgEnum type, ScriptRef s, size_t valueType)
 		if (data->second.values.size() < data->second.limit)
 		{
 			data->second.values.push_back(TagValueData{ s, valueType });
+			++_refVersion;
 			addSortHelper(_refList, { s, type, data->second.crate(data->second.values.size()) });
 			return data->second.values.size();
 		}
@@ -3777,6 +4830,22 @@ void ScriptGlobal::endLoad()
 	}
 	_parserNames.clear();
 	_parserEvents.clear();
+	saveScriptCache();
+}
+
+/**
+ * Get hash of all global names and values, used to check if compiled scripts are still valid.
+ */
+const std::string& ScriptGlobal::getRefHash() const
+{
+	if (_refHashVersion != _refVersion)
+	{
+		MD5 hash;
+		hashRefList(hash, _refList);
+		_refHash = hash.finalize().hexdigest();
+		_refHashVersion = _refVersion;
+	}
+	return _refHash;
 }
 
 /**
@@ -22,6 +22,7 @@
 #include <vector>
 #include <string>
 #include <cstring>
+#include <bitset>
 #include <yaml-cpp/yaml.h>
 #include <SDL_stdinc.h>
 #include <cassert>
@@ -373,7 +374,9 @@ struct TypeInfo
 class ScriptContainerBase
 {
 	friend struct ParserWriter;
+	friend class ScriptParserBase;
 	std::vector<Uint8> _proc;
+	std::bitset<ScriptMaxReg> _regUsed;
 
 public:
 	/// Constructor.
@@ -402,6 +405,12 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+
+	/// Test if script reads or writes given reg.
+	bool isRegUsed(size_t reg) const
+	{
+		return reg < _regUsed.size() && _regUsed[reg];
+	}
 };
 
 /**
@@ -449,6 +458,11 @@ public:
 	{
 		return _events;
 	}
+	/// Get script without events.
+	const ScriptContainerBase& current() const
+	{
+		return _current;
+	}
 };
 
 /**
@@ -674,6 +688,13 @@ class ScriptWorkerBase
 	}
 
 protected:
+	/// Get reg offset of output value at given position.
+	template<typename... Args>
+	static constexpr size_t offsetOutputReg(helper::TypeTag<ScriptOutputArgs<Args...>>, int i)
+	{
+		return offset<void, Args...>(i, 0);
+	}
+
 	/// Update values in script.
 	template<typename Output, typename... Args>
 	void updateBase(Args... args)
@@ -803,13 +824,20 @@ class ScriptWorkerBlit : public ScriptWorkerBase
 	/// Current script set in worker.
 	const Uint8* _proc;
 	const ScriptContainerBase* _events;
+	/// Script result depends only on source pixel.
+	bool _sourceOnly;
+
+	/// Check if any of scripts use destination pixel.
+	static bool isDestUsed(const ScriptContainerBase& proc, const ScriptContainerBase* events);
+	/// Calculate new value of one pixel.
+	int executePixel(Uint8 src, Uint8 dest);
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr), _sourceOnly(false)
 	{
 
 	}
@@ -824,6 +852,7 @@ public:
 		{
 			_proc = c.data();
 			_events = nullptr;
+			_sourceOnly = !isDestUsed(c, nullptr);
 			updateBase<Output>(args...);
 		}
 	}
@@ -838,6 +867,7 @@ public:
 		{
 			_proc = c.data();
 			_events = c.dataEvents();
+			_sourceOnly = !isDestUsed(c.current(), _events);
 			updateBase<Output>(args...);
 		}
 	}
@@ -852,9 +882,21 @@ public:
 	{
 		_proc = nullptr;
 		_events = nullptr;
+		_sourceOnly = false;
 	}
 };
 
+/**
+ * Cost of executed scripts, collected when oxceScriptProfiler is enabled.
+ */
+namespace ScriptProfiler
+{
+	/// Log collected statistics per script, hook and mod.
+	void dump(const std::string& reason);
+	/// Forget collected statistics.
+	void reset();
+}
+
 ////////////////////////////////////////////////////////////
 //					objects ranges
 ////////////////////////////////////////////////////////////
@@ -1167,6 +1209,16 @@ class ScriptParserBase
 	std::vector<ScriptTypeData> _typeList;
 	std::vector<ScriptProcData> _procList;
 	std::vector<ScriptRefData> _refList;
+	size_t _refVersion;
+	mutable size_t _refHashVersion;
+	mutable std::string _refHash;
+
+	/// Get key of compiled script in cache.
+	std::string getCacheKey(const std::string& srcCode) const;
+	/// Try loading compiled script from cache.
+	bool loadCache(const std::string& key, ScriptContainerBase& destScript) const;
+	/// Store compiled script in cache.
+	void storeCache(const std::string& key, const ScriptContainerBase& srcScript, const ParserWriter& help) const;
 
 protected:
 	template<typename First, typename... Rest>
@@ -1620,9 +1672,13 @@ private:
 	std::map<ArgEnum, TagData> _tagNames;
 	std::vector<TagValueType> _tagValueTypes;
 	std::vector<ScriptRefData> _refList;
+	std::string _currentMod;
+	size_t _refVersion = 0;
+	mutable size_t _refHashVersion = (size_t)-1;
+	mutable std::string _refHash;
 
 	/// Get tag value.
-	size_t getTag(ArgEnum type, ScriptRef s) const;
+	size_t getTag(ArgEnum type, ScriptRef prefix, ScriptRef postfix = {}) const;
 	/// Get data of tag value.
 	TagValueData getTagValueData(ArgEnum type, size_t i) const;
 	/// Get tag value type data.
@@ -1704,6 +1760,13 @@ public:
 
 	/// Load global data from YAML.
 	void load(const YAML::Node& node);
+
+	/// Set name of mod that scripts are loaded from.
+	void setCurrentMod(const std::string& name) { _currentMod = name; }
+	/// Get name of mod that scripts are loaded from.
+	const std::string& getCurrentMod() const { return _currentMod; }
+	/// Get hash of all global names and values.
+	const std::string& getRefHash() const;
 };
 
 /**
@@ -1711,12 +1774,30 @@ public:
  */
 class ScriptValuesBase
 {
-	/// Vector with all available values for script.
-	std::vector<int> values;
+	/// Number of values that are stored without heap allocation.
+	static constexpr Uint32 InlineSize = 4;
+
+	/// Values of first tags, or pointer to values of all tags if there is more of them.
+	union
+	{
+		int _inline[InlineSize];
+		int* _heap;
+	};
+	/// Number of available values.
+	Uint32 _size;
+	/// Number of values that can be stored without reallocation.
+	Uint32 _capacity;
+
+	/// Get pointer to values.
+	int* data() { return _capacity > InlineSize ? _heap : _inline; }
+	/// Get pointer to values.
+	const int* data() const { return _capacity > InlineSize ? _heap : _inline; }
+	/// Change number of values, new ones are zero.
+	void resize(Uint32 size);
 
 protected:
 	/// Get all values
-	const std::vector<int> &getValues() const { return values; }
+	ScriptRange<int> getValues() const { return { data(), data() + _size }; }
 	/// Set value.
 	void setBase(size_t t, int i);
 	/// Get value.
@@ -1725,6 +1806,21 @@ protected:
 	void loadBase(const YAML::Node &node, const ScriptGlobal* shared, ArgEnum type, const std::string& nodeName);
 	/// Save values to yaml file.
 	void saveBase(YAML::Node &node, const ScriptGlobal* shared, ArgEnum type, const std::string& nodeName) const;
+
+public:
+	/// Default constructor.
+	ScriptValuesBase() : _inline{ }, _size{ 0 }, _capacity{ InlineSize } { }
+	/// Copy constructor.
+	ScriptValuesBase(const ScriptValuesBase& other);
+	/// Move constructor.
+	ScriptValuesBase(ScriptValuesBase&& other) noexcept;
+	/// Destructor.
+	~ScriptValuesBase();
+
+	/// Copy.
+	ScriptValuesBase& operator=(const ScriptValuesBase& other);
+	/// Move.
+	ScriptValuesBase& operator=(ScriptValuesBase&& other) noexcept;
 };
 
 /**
@@ -1759,7 +1855,7 @@ public:
 		return setBase(t.get(), i);
 	}
 	/// Get all values
-	const std::vector<int> &getValuesRaw() const { return getValues(); }
+	ScriptRange<int> getValuesRaw() const { return getValues(); }
 };
 
 ////////////////////////////////////////////////////////////
@@ -95,6 +95,21 @@ struct ParserWriter
 	/// Tag type representing position script operation id in proc vector.
 	class ProcOp { };
 
+	/// Place in proc vector storing pointer that is different in each run of game.
+	struct Relocation
+	{
+		enum Kind : Uint8 { Func, Text, Const };
+
+		Kind kind;
+		ProgPos pos;
+		/// Custom function for Func.
+		const ScriptProcData* proc;
+		/// Version of function for Func, offset of string for Text.
+		size_t value;
+		/// Name of constant for Const.
+		ScriptRef name;
+	};
+
 	/// List of all places in proc vector where we need have same values
 	template<typename T, typename CompType = T>
 	class ReservedCrossRefrenece
@@ -152,6 +167,8 @@ struct ParserWriter
 	ReservedCrossRefrenece<ProgPos> refLabels;
 	/// list of texts.
 	ReservedCrossRefrenece<ScriptText, ScriptRef> refTexts;
+	/// list of pointers in proc vector.
+	std::vector<Relocation> relocations;
 
 	/// index of used script registers.
 	RegEnum regIndexUsed;
@@ -198,6 +215,12 @@ struct ParserWriter
 	{
 		update(pos.getPos(), &value, sizeof(T));
 	}
+	/// Setting previously prepared place with custom function.
+	void updateReservedFunc(ReservedPos<ScriptFunc> pos, const ScriptProcData& spd, int version)
+	{
+		updateReserved<ScriptFunc>(pos, spd.parserGet(version));
+		relocations.push_back(Relocation{ Relocation::Func, pos.getPos(), &spd, static_cast<size_t>(version), {} });
+	}
 
 
 	/// Push custom value on proc vector.
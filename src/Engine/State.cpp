@@ -35,6 +35,7 @@
 #include "../Interface/ComboBox.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/FpsCounter.h"
+#include "../Interface/FrameGraph.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Mod/RuleInterface.h"
 
@@ -263,6 +264,9 @@ void State::init()
 	_game->getFpsCounter()->setPalette(_palette);
 	_game->getFpsCounter()->setColor(_cursorColor);
 	_game->getFpsCounter()->draw();
+	_game->getFrameGraph()->setPalette(_palette);
+	if (_game->getLanguage() && _game->getMod())
+		_game->getFrameGraph()->initText(_game->getMod()->getFont("FONT_BIG"), _game->getMod()->getFont("FONT_SMALL"), _game->getLanguage());
 
 	// Highest priority: custom sound set explicitly in the code
 	// Medium priority: sound defined by the interface ruleset
@@ -346,6 +350,23 @@ void State::blit()
 	}
 }
 
+/**
+ * Checks if any of the state's Surface child elements
+ * will be redrawn the next time the state is blitted.
+ * @return True if a surface is waiting to be redrawn.
+ */
+bool State::isRedrawPending() const
+{
+	for (auto* surface : _surfaces)
+	{
+		if (surface->isRedrawPending())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Hides all the Surface child elements on display.
  */
@@ -549,6 +570,7 @@ void State::setModPalette()
 		_game->getCursor()->draw();
 		_game->getFpsCounter()->setPalette(_palette);
 		_game->getFpsCounter()->draw();
+		_game->getFrameGraph()->setPalette(_palette);
 	}
 }
 
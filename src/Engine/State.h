@@ -85,6 +85,8 @@ public:
 	virtual void think();
 	/// Blits the state to the screen.
 	virtual void blit();
+	/// Checks if any of the state surfaces will be redrawn on the next blit.
+	virtual bool isRedrawPending() const;
 	/// Hides all the state surfaces.
 	void hideAll();
 	/// Shows all the state surfaces.
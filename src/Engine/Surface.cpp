@@ -29,6 +29,7 @@
 #include "Logger.h"
 #include "SDL2Helpers.h"
 #include "FileMap.h"
+#include "Zoom.h"
 #ifdef _WIN32
 #include <malloc.h>
 #endif
@@ -43,6 +44,8 @@
 namespace OpenXcom
 {
 
+std::atomic<bool> Surface::_changed(true);
+
 
 namespace
 {
@@ -293,6 +296,7 @@ Surface::~Surface()
 template <typename T>
 void Surface::rawCopy(const std::vector<T> &src)
 {
+	markChanged();
 	// Copy whole thing
 	if (_surface->pitch == _surface->w)
 	{
@@ -536,6 +540,7 @@ void Surface::loadBdy(const std::string &filename)
  */
 void Surface::clear()
 {
+	markChanged();
 	CleanSdlSurface(_surface.get());
 }
 
@@ -550,6 +555,7 @@ void Surface::clear()
  */
 void Surface::offset(int off, int min, int max, int mul)
 {
+	markChanged();
 	if (off == 0)
 		return;
 
@@ -600,6 +606,7 @@ void Surface::offset(int off, int min, int max, int mul)
  */
 void Surface::offsetBlock(int off, int blk, int mul)
 {
+	markChanged();
 	if (off == 0)
 		return;
 
@@ -650,6 +657,7 @@ void Surface::offsetBlock(int off, int blk, int mul)
  */
 void Surface::invert(Uint8 mid)
 {
+	markChanged();
 	// Lock the surface
 	lock();
 
@@ -702,13 +710,17 @@ void Surface::blit(SDL_Surface *surface)
 {
 	if (_visible && !_hidden)
 	{
+		markChanged();
 		if (_redraw)
 			draw();
 
 		SDL_Rect target {};
 		target.x = getX();
 		target.y = getY();
-		SDL_BlitSurface(_surface.get(), nullptr, surface, &target);
+		if (!Zoom::blitPalettized(_surface.get(), surface, target.x, target.y))
+		{
+			SDL_BlitSurface(_surface.get(), nullptr, surface, &target);
+		}
 	}
 }
 
@@ -721,6 +733,7 @@ void Surface::blit(SDL_Surface *surface)
  */
 void Surface::copy(Surface *surface)
 {
+	markChanged();
 	/*
 	SDL_BlitSurface uses colour matching,
 	and is therefor unreliable as a means
@@ -758,6 +771,7 @@ void Surface::copy(Surface *surface)
  */
 void Surface::drawRect(SDL_Rect *rect, Uint8 color)
 {
+	markChanged();
 	SDL_FillRect(_surface.get(), rect, color);
 }
 
@@ -771,6 +785,7 @@ void Surface::drawRect(SDL_Rect *rect, Uint8 color)
  */
 void Surface::drawRect(Sint16 x, Sint16 y, Sint16 w, Sint16 h, Uint8 color)
 {
+	markChanged();
 	SDL_Rect rect;
 	rect.w = w;
 	rect.h = h;
@@ -789,6 +804,7 @@ void Surface::drawRect(Sint16 x, Sint16 y, Sint16 w, Sint16 h, Uint8 color)
  */
 void Surface::drawLine(Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 color)
 {
+	markChanged();
 	lineColor(_surface.get(), x1, y1, x2, y2, Palette::getRGBA(getPalette(), color));
 }
 
@@ -801,6 +817,7 @@ void Surface::drawLine(Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Uint8 color)
  */
 void Surface::drawCircle(Sint16 x, Sint16 y, Sint16 r, Uint8 color)
 {
+	markChanged();
 	filledCircleColor(_surface.get(), x, y, r, Palette::getRGBA(getPalette(), color));
 }
 
@@ -813,6 +830,7 @@ void Surface::drawCircle(Sint16 x, Sint16 y, Sint16 r, Uint8 color)
  */
 void Surface::drawPolygon(Sint16 *x, Sint16 *y, int n, Uint8 color)
 {
+	markChanged();
 	filledPolygonColor(_surface.get(), x, y, n, Palette::getRGBA(getPalette(), color));
 }
 
@@ -827,6 +845,7 @@ void Surface::drawPolygon(Sint16 *x, Sint16 *y, int n, Uint8 color)
  */
 void Surface::drawTexturedPolygon(Sint16 *x, Sint16 *y, int n, Surface *texture, int dx, int dy)
 {
+	markChanged();
 	texturedPolygon(_surface.get(), x, y, n, texture->getSurface(), dx, dy);
 }
 
@@ -839,6 +858,7 @@ void Surface::drawTexturedPolygon(Sint16 *x, Sint16 *y, int n, Surface *texture,
  */
 void Surface::drawString(Sint16 x, Sint16 y, const char *s, Uint8 color)
 {
+	markChanged();
 	stringColor(_surface.get(), x, y, s, Palette::getRGBA(getPalette(), color));
 }
 
@@ -848,6 +868,7 @@ void Surface::drawString(Sint16 x, Sint16 y, const char *s, Uint8 color)
  */
 void Surface::setX(int x)
 {
+	markChanged();
 	_x = x;
 }
 
@@ -857,6 +878,7 @@ void Surface::setX(int x)
  */
 void Surface::setY(int y)
 {
+	markChanged();
 	_y = y;
 }
 
@@ -867,6 +889,7 @@ void Surface::setY(int y)
  */
 void Surface::setVisible(bool visible)
 {
+	markChanged();
 	_visible = visible;
 }
 
@@ -896,6 +919,7 @@ SurfaceCrop Surface::getCrop() const
  */
 void Surface::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
 {
+	markChanged();
 	if (_surface->format->BitsPerPixel == 8)
 		SDL_SetColors(_surface.get(), const_cast<SDL_Color *>(colors), firstcolor, ncolors);
 }
@@ -909,6 +933,7 @@ void Surface::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
  */
 void Surface::setHidden(bool hidden)
 {
+	markChanged();
 	_hidden = hidden;
 }
 
@@ -934,27 +959,45 @@ void Surface::unlock()
 }
 
 /**
- * Specific blit function to blit battlescape terrain data in different shades in a fast way.
+ * Blits a part of a sprite with a shade offset row by row,
+ * with the vectorized kernels picked for the CPU by Zoom.
+ * Gives the same result as ShaderDraw with helper::StandardShade
+ * or helper::ColorReplace.
+ * @param dest Surface to blit to.
+ * @param src Sprite to blit.
+ * @param x X position of the sprite on the surface.
+ * @param y Y position of the sprite on the surface.
+ * @param srcArea Part of the sprite to blit.
+ * @param destArea Part of the surface that can be drawn on.
+ * @param shade Shade offset.
+ * @param newColor New color group (already multiplied by 16), or -1 to keep the original one.
  */
-void Surface::blitRaw(SurfaceRaw<Uint8> destSurf, SurfaceRaw<const Uint8> srcSurf, int x, int y, int shade, bool half, int newBaseColor)
+static void shadeBlit(SurfaceRaw<Uint8> dest, SurfaceRaw<const Uint8> src, int x, int y, const GraphSubset &srcArea, const GraphSubset &destArea, int shade, int newColor)
 {
-	ShaderMove<const Uint8> src(srcSurf, x, y);
-	if (half)
+	const GraphSubset area = GraphSubset::intersection(srcArea.offset(x, y), destArea, GraphSubset(dest.getWidth(), dest.getHeight()));
+	if (!area)
 	{
-		GraphSubset g = src.getDomain();
-		g.beg_x = g.end_x/2;
-		src.setDomain(g);
+		return;
 	}
-	if (newBaseColor)
+	Uint8 *destRow = dest.getBuffer() + area.beg_y * dest.getPitch() + area.beg_x;
+	const Uint8 *srcRow = src.getBuffer() + (area.beg_y - y) * src.getPitch() + (area.beg_x - x);
+	for (int row = area.beg_y; row < area.end_y; ++row, destRow += dest.getPitch(), srcRow += src.getPitch())
 	{
-		--newBaseColor;
-		newBaseColor <<= 4;
-		ShaderDraw<helper::ColorReplace>(ShaderSurface(destSurf), src, ShaderScalar(shade), ShaderScalar(newBaseColor));
+		Zoom::shadeRow(destRow, srcRow, area.size_x(), shade, newColor);
 	}
-	else
+}
+
+/**
+ * Specific blit function to blit battlescape terrain data in different shades in a fast way.
+ */
+void Surface::blitRaw(SurfaceRaw<Uint8> destSurf, SurfaceRaw<const Uint8> srcSurf, int x, int y, int shade, bool half, int newBaseColor)
+{
+	GraphSubset g(srcSurf.getWidth(), srcSurf.getHeight());
+	if (half)
 	{
-		ShaderDraw<helper::StandardShade>(ShaderSurface(destSurf), src, ShaderScalar(shade));
+		g.beg_x = g.end_x/2;
 	}
+	shadeBlit(destSurf, srcSurf, x, y, g, GraphSubset(destSurf.getWidth(), destSurf.getHeight()), shade, newBaseColor ? (newBaseColor - 1) << 4 : -1);
 }
 
 /**
@@ -983,12 +1026,7 @@ void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, boo
  */
 void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, GraphSubset range) const
 {
-	ShaderMove<const Uint8> src(this, x, y);
-	ShaderMove<Uint8> dest(surface);
-
-	dest.setDomain(range);
-
-	ShaderDraw<helper::StandardShade>(dest, src, ShaderScalar(shade));
+	shadeBlit(surface, SurfaceRaw<const Uint8>(this), x, y, GraphSubset(getWidth(), getHeight()), range, shade, -1);
 }
 
 /**
@@ -997,6 +1035,7 @@ void Surface::blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, Gra
  */
 void Surface::invalidate(bool valid)
 {
+	markChanged();
 	_redraw = valid;
 }
 
@@ -1009,6 +1048,7 @@ void Surface::invalidate(bool valid)
  */
 void Surface::resize(int width, int height)
 {
+	markChanged();
 	// Set up new surface
 	Uint8 bpp = _surface->format->BitsPerPixel;
 	auto alignedBuffer = NewAlignedBuffer(bpp, width, height);
@@ -22,6 +22,7 @@
 #include <vector>
 #include <memory>
 #include <vector>
+#include <atomic>
 #include <assert.h>
 #include "GraphSubset.h"
 
@@ -89,6 +90,7 @@ protected:
 	Uint8 _visible: 1;
 	Uint8 _hidden: 1;
 	Uint8 _redraw: 1;
+	static std::atomic<bool> _changed;
 
 	/// Copies raw pixels.
 	template <typename T>
@@ -210,6 +212,7 @@ public:
 		{
 			return;
 		}
+		markChanged();
 		*getRaw(x, y) = pixel;
 	}
 	/**
@@ -321,6 +324,14 @@ public:
 	void blitNShade(SurfaceRaw<Uint8> surface, int x, int y, int shade, GraphSubset range) const;
 	/// Invalidate the surface: force it to be redrawn
 	void invalidate(bool valid = true);
+	/// Checks if the surface will be redrawn on the next blit.
+	virtual bool isRedrawPending() const { return _redraw; }
+	/// Notes that a surface was drawn on or changed.
+	static void markChanged() { if (!_changed.load(std::memory_order_relaxed)) _changed.store(true, std::memory_order_relaxed); }
+	/// Checks if any surface was drawn on or changed since the last clearChanged().
+	static bool isChanged() { return _changed.load(std::memory_order_relaxed); }
+	/// Forgets the changes made to the surfaces so far.
+	static void clearChanged() { _changed.store(false, std::memory_order_relaxed); }
 
 	/// Sets the color of the surface.
 	virtual void setColor(Uint8 /*color*/) { /* empty by design */ };
@@ -374,6 +385,11 @@ public:
 	{
 		if (surf)
 		{
+			if (!std::is_const<Pixel>::value)
+			{
+				// only drawing needs a writable view
+				Surface::markChanged();
+			}
 			*this = SurfaceRaw{ surf->getBuffer(), surf->getWidth(), surf->getHeight(), surf->getPitch() };
 		}
 	}
@@ -394,6 +410,10 @@ public:
 	{
 		if (surf)
 		{
+			if (!std::is_const<Pixel>::value)
+			{
+				Surface::markChanged();
+			}
 			*this = SurfaceRaw{ (Pixel*)surf->pixels, surf->w, surf->h, surf->pitch };
 		}
 	}
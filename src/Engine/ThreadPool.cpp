@@ -0,0 +1,134 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a pool, starting the worker threads.
+ * @param threads Number of threads that run jobs, including the calling thread.
+ */
+ThreadPool::ThreadPool(int threads) : _job(nullptr), _next(0), _count(0), _pending(0), _quit(false)
+{
+	for (int i = 1; i < threads; ++i)
+	{
+		_workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+/**
+ * Stops and joins all the worker threads.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_wake.notify_all();
+	for (auto& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+/**
+ * Takes jobs one by one until all of them are started.
+ * @param lock Lock on the pool mutex, released while a job runs.
+ */
+void ThreadPool::runJobs(std::unique_lock<std::mutex> &lock)
+{
+	while (_next < _count)
+	{
+		int i = _next++;
+		const std::function<void(int)> *job = _job;
+		lock.unlock();
+		(*job)(i);
+		lock.lock();
+		if (--_pending == 0)
+		{
+			_done.notify_all();
+		}
+	}
+}
+
+/**
+ * Waits for jobs and runs them until the pool is destroyed.
+ */
+void ThreadPool::work()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true)
+	{
+		_wake.wait(lock, [this]{ return _quit || _next < _count; });
+		if (_quit)
+		{
+			return;
+		}
+		runJobs(lock);
+	}
+}
+
+/**
+ * Runs a job for each index in [0, count) spread over all threads
+ * and returns once all of them are finished.
+ * @param count Number of jobs.
+ * @param job Function called with the job index.
+ */
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &job)
+{
+	if (_workers.empty() || count <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(i);
+		}
+		return;
+	}
+	std::unique_lock<std::mutex> lock(_mutex);
+	_job = &job;
+	_next = 0;
+	_count = count;
+	_pending = count;
+	_wake.notify_all();
+	runJobs(lock);
+	_done.wait(lock, [this]{ return _pending == 0; });
+	_job = nullptr;
+	_next = 0;
+	_count = 0;
+}
+
+/**
+ * Converts a thread count setting to the actual number of threads.
+ * @param setting Number of threads, 0 or less to use all the available cores (up to 8).
+ * @return Number of threads, at least 1.
+ */
+int ThreadPool::getThreadCount(int setting)
+{
+	if (setting > 0)
+	{
+		return std::min(setting, 64);
+	}
+	int cores = (int)std::thread::hardware_concurrency();
+	return std::max(1, std::min(cores, 8));
+}
+
+}
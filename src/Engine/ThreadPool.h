@@ -0,0 +1,63 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace OpenXcom
+{
+
+/**
+ * A set of persistent worker threads for splitting work into independent jobs.
+ * The calling thread takes part in the work too and waits until all jobs are done.
+ */
+class ThreadPool
+{
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _wake, _done;
+	const std::function<void(int)> *_job;
+	int _next, _count, _pending;
+	bool _quit;
+
+	/// Runs jobs until there are none left to start.
+	void runJobs(std::unique_lock<std::mutex> &lock);
+	/// Main loop of a worker thread.
+	void work();
+public:
+	/// Creates a pool that uses the given number of threads, caller included.
+	ThreadPool(int threads);
+	/// Stops all worker threads.
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// Gets the number of threads, caller included.
+	int getSize() const { return (int)_workers.size() + 1; }
+	/// Runs job(0) .. job(count - 1) in parallel and waits for all of them.
+	void parallelFor(int count, const std::function<void(int)> &job);
+	/// Gets the number of threads to use for a thread count setting, 0 meaning auto detect.
+	static int getThreadCount(int setting);
+};
+
+}
@@ -18,6 +18,7 @@
  */
 
 #include "Zoom.h"
+#include "ZoomKernels.h"
 
 #include "Surface.h"
 #include "Logger.h"
@@ -25,6 +26,9 @@
 #include "Screen.h"
 
 #include "OpenGL.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
 
 // Scale2X
 #include "Scalers/scalebit.h"
@@ -46,12 +50,6 @@
 #include <intrin.h>
 #endif
 
-#ifdef __GNUC__
-#if (__i386__ || __x86_64__)
-#include <cpuid.h>
-#endif
-#endif
-
 #ifdef __SSE2__
 #include <emmintrin.h> // for SSE2 intrinsics; see http://msdn.microsoft.com/en-us/library/has3d153%28v=vs.71%29.aspx
 #endif
@@ -632,26 +630,44 @@ static int zoomSurface2X_SSE2(SDL_Surface *src, SDL_Surface *dst)
  */
 bool Zoom::haveSSE2()
 {
-#ifdef __GNUC__
-	unsigned int CPUInfo[4] = {0, 0, 0, 0};
-	#if (__e2k__) // e2k - MCST Elbrus 2000 architecture
-		#ifdef __SSE2__
-			CPUInfo[3] = 0x04000000;
-		#endif
-	#else // i386/x86_64
-		__get_cpuid(1, CPUInfo, CPUInfo+1, CPUInfo+2, CPUInfo+3);
-	#endif
-#elif _WIN32
-	int CPUInfo[4];
-	__cpuid(CPUInfo, 1);
-#else
-	unsigned int CPUInfo[4] = {0, 0, 0, 0};
+	return ZoomKernels::haveSSE2();
+}
+
 #endif
 
-	return (CPUInfo[3] & 0x04000000) ? true : false;
+/**
+ * Gets the worker threads shared by the 32-bit scalers.
+ * The pool is recreated when the thread count setting changes.
+ * @return Thread pool.
+ */
+static ThreadPool &getScalerPool()
+{
+	static std::unique_ptr<ThreadPool> pool;
+	int threads = ThreadPool::getThreadCount(Options::oxceScalerThreads);
+	if (!pool || pool->getSize() != threads)
+	{
+		pool.reset();
+		pool = std::make_unique<ThreadPool>(threads);
+	}
+	return *pool;
 }
 
-#endif
+/**
+ * Splits scaling of an image into bands of source rows processed in parallel.
+ * Scalers read the rows around a band too, but each one writes only its own part of the output.
+ * @param height Number of source rows.
+ * @param scaleRows Function scaling the half-open range of source rows [yFirst, yLast).
+ */
+static void scaleInBands(int height, const std::function<void(int, int)> &scaleRows)
+{
+	ThreadPool &pool = getScalerPool();
+	// keep the bands at least 16 rows high, the first row of each band is slower to process
+	int bands = std::max(1, std::min(pool.getSize(), height / 16));
+	pool.parallelFor(bands, [&](int band)
+	{
+		scaleRows(height * band / bands, height * (band + 1) / bands);
+	});
+}
 
 /**
  * Wrapper around various software and OpenGL screen buffer pushing functions which zoom.
@@ -674,7 +690,11 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 #ifndef __NO_OPENGL
 		if (glOut->buffer_surface)
 		{
-			SDL_BlitSurface(src, 0, glOut->surface.get(), 0); // TODO; this is less than ideal...
+			// the texture is scaled by OpenGL itself, so only the palette needs expanding here
+			if (!blitPalettized(src, glOut->surface.get(), 0, 0))
+			{
+				SDL_BlitSurface(src, 0, glOut->surface.get(), 0);
+			}
 
 			glOut->refresh(glOut->linear, glOut->iwidth, glOut->iheight, dst->w, dst->h, topBlackBand, bottomBlackBand, leftBlackBand, rightBlackBand);
 			SDL_GL_SwapBuffers();
@@ -687,8 +707,11 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (dstWidth == src->w && dstHeight == src->h)
 	{
-		SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)src->w, (Uint16)src->h};
-		SDL_BlitSurface(src, NULL, dst, &dstrect);
+		if (!blitPalettized(src, dst, leftBlackBand, topBlackBand))
+		{
+			SDL_Rect dstrect = {(Sint16)leftBlackBand, (Sint16)topBlackBand, (Uint16)src->w, (Uint16)src->h};
+			SDL_BlitSurface(src, NULL, dst, &dstrect);
+		}
 	}
 	else
 	{
@@ -738,7 +761,10 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			{
 				if (dst->w == src->w * (int)factor && dst->h == src->h * (int)factor)
 				{
-					xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB);
+					scaleInBands(src->h, [&](int yFirst, int yLast)
+					{
+						xbrz::scale(factor, (uint32_t*)src->pixels, (uint32_t*)dst->pixels, src->w, src->h, xbrz::RGB, xbrz::ScalerCfg(), yFirst, yLast);
+					});
 					return 0;
 				}
 			}
@@ -746,31 +772,32 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 		if (Options::useHQXFilter)
 		{
-			static bool initDone = false;
-
-			if (!initDone)
-			{
-				hqxInit();
-				initDone = true;
-			}
-
-			// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
+			// HQX_API void HQX_CALLCONV hq2x_32_rb_slice( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height, int yFirst, int yLast );
 
 			if (dst->w == src->w * 2 && dst->h == src->h * 2)
 			{
-				hq2x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq2x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 3 && dst->h == src->h * 3)
 			{
-				hq3x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq3x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 
 			if (dst->w == src->w * 4 && dst->h == src->h * 4)
 			{
-				hq4x_32_rb((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h);
+				scaleInBands(src->h, [&](int yFirst, int yLast)
+				{
+					hq4x_32_rb_slice((uint32_t*)src->pixels, src->pitch, (uint32_t*)dst->pixels, dst->pitch, src->w, src->h, yFirst, yLast);
+				});
 				return 0;
 			}
 		}
@@ -936,6 +963,107 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	return 0;
 }
 
+/**
+ * Picks the fastest palette expansion kernel supported by the CPU.
+ * @return Kernel function.
+ */
+static ZoomKernels::PaletteRow selectPaletteRowKernel()
+{
+	auto kernels = ZoomKernels::getPaletteRowKernels();
+	if (kernels.size() > 1)
+	{
+		Log(LOG_INFO) << "Using " << kernels.back().name << " palette expansion routine.";
+	}
+	return kernels.back().func;
+}
 
+/**
+ * Converts a row of 8-bit pixels to 32-bit ones through a palette lookup table.
+ * @param src Source pixels.
+ * @param dst Destination pixels.
+ * @param width Number of pixels.
+ * @param lut 32-bit color for each of the 256 palette entries.
+ * @param colorKey Palette index that is left untouched in the destination, or -1 for none.
+ */
+void Zoom::expandPaletteRow(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey)
+{
+	static const ZoomKernels::PaletteRow kernel = selectPaletteRowKernel();
+	kernel(src, dst, width, lut, colorKey);
 }
 
+/**
+ * Blits an 8-bit palettized surface onto a 32-bit one, like SDL_BlitSurface but with
+ * the vectorized palette expansion. Surfaces that need anything else than a plain
+ * palette lookup with an optional color key are left to SDL.
+ * @param src The 8-bit surface.
+ * @param dst The 32-bit surface.
+ * @param x Destination X position.
+ * @param y Destination Y position.
+ * @return True if blitted, false if the caller has to use SDL_BlitSurface() instead.
+ */
+bool Zoom::blitPalettized(SDL_Surface *src, SDL_Surface *dst, int x, int y)
+{
+	if (src->format->BitsPerPixel != 8 || !src->format->palette || dst->format->BitsPerPixel != 32
+		|| SDL_MUSTLOCK(src) || SDL_MUSTLOCK(dst) || (src->flags & SDL_SRCALPHA))
+	{
+		return false;
+	}
+	const SDL_Rect &clip = dst->clip_rect;
+	int x1 = std::max(x, (int)clip.x);
+	int y1 = std::max(y, (int)clip.y);
+	int x2 = std::min(x + src->w, clip.x + (int)clip.w);
+	int y2 = std::min(y + src->h, clip.y + (int)clip.h);
+	if (x1 >= x2 || y1 >= y2)
+	{
+		return true;
+	}
+
+	Uint32 lut[256] = { };
+	const SDL_Palette *palette = src->format->palette;
+	for (int i = 0; i < palette->ncolors && i < 256; ++i)
+	{
+		lut[i] = SDL_MapRGB(dst->format, palette->colors[i].r, palette->colors[i].g, palette->colors[i].b);
+	}
+	int colorKey = (src->flags & SDL_SRCCOLORKEY) ? (int)src->format->colorkey : -1;
+
+	const Uint8 *srcRow = (const Uint8 *)src->pixels + (y1 - y) * src->pitch + (x1 - x);
+	Uint8 *dstRow = (Uint8 *)dst->pixels + y1 * dst->pitch + x1 * 4;
+	for (int row = y1; row < y2; ++row, srcRow += src->pitch, dstRow += dst->pitch)
+	{
+		expandPaletteRow(srcRow, (Uint32 *)dstRow, x2 - x1, lut, colorKey);
+	}
+	return true;
+}
+
+
+
+/**
+ * Picks the fastest shade kernel supported by the CPU.
+ * @return Kernel function.
+ */
+static ZoomKernels::ShadeRow selectShadeRowKernel()
+{
+	auto kernels = ZoomKernels::getShadeRowKernels();
+	if (kernels.size() > 1)
+	{
+		Log(LOG_INFO) << "Using " << kernels.back().name << " shade blit routine.";
+	}
+	return kernels.back().func;
+}
+
+/**
+ * Blits a row of 8-bit sprite pixels onto a row of surface pixels with a shade offset,
+ * skipping the transparent (0) ones, like helper::StandardShade and helper::ColorReplace.
+ * @param dest Destination pixels.
+ * @param src Source pixels.
+ * @param width Number of pixels.
+ * @param shade Shade offset.
+ * @param newColor New color group of the pixels (already multiplied by 16), or -1 to keep theirs.
+ */
+void Zoom::shadeRow(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor)
+{
+	static const ZoomKernels::ShadeRow kernel = selectShadeRowKernel();
+	kernel(dest, src, width, shade, newColor);
+}
+
+}
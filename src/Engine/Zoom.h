@@ -34,6 +34,12 @@ class Zoom
 	static int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy);
 	/// Check for SSE2 instructions using CPUID.
 	static bool haveSSE2();
+	/// Convert a row of 8-bit pixels to 32-bit ones through a palette lookup table.
+	static void expandPaletteRow(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey);
+	/// Blit an 8-bit surface onto a 32-bit one using the fastest palette expansion available.
+	static bool blitPalettized(SDL_Surface *src, SDL_Surface *dst, int x, int y);
+	/// Blit a row of 8-bit sprite pixels with a shade offset using the fastest kernel available.
+	static void shadeRow(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor);
 
 private:
 
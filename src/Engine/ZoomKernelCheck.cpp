@@ -0,0 +1,217 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "ZoomKernels.h"
+
+/*
+ * Checks that every vectorized blit kernel the CPU supports gives the
+ * same pixels as the scalar one, and times them. Built with the
+ * BUILD_KERNEL_CHECK option and run by ctest; fails on any mismatch.
+ */
+
+using namespace OpenXcom;
+
+namespace
+{
+
+/// Rows timed for each kernel.
+const int BENCH_ROWS = 20000;
+/// Width of the timed rows.
+const int BENCH_WIDTH = 640;
+
+/**
+ * Gets the row widths to check: every tail length the vector
+ * loops can leave, and some screen widths.
+ */
+std::vector<int> getWidths()
+{
+	std::vector<int> widths;
+	for (int i = 0; i <= 80; ++i)
+	{
+		widths.push_back(i);
+	}
+	for (int i : { 320, 640, 1021, 1920 })
+	{
+		widths.push_back(i);
+	}
+	return widths;
+}
+
+/**
+ * Fills a row with random pixels, with runs of the transparent
+ * color long enough for the kernels to skip whole vectors.
+ * @param rng Random generator.
+ * @param row Row to fill.
+ * @param transparent Transparent color, or -1 for none.
+ */
+void fillRow(std::mt19937 &rng, std::vector<Uint8> &row, int transparent)
+{
+	for (size_t i = 0; i < row.size();)
+	{
+		size_t run = std::min(row.size() - i, (size_t)(rng() % 48 + 1));
+		bool clear = transparent >= 0 && rng() % 3 == 0;
+		for (size_t j = 0; j < run; ++j, ++i)
+		{
+			row[i] = clear ? (Uint8)transparent : (Uint8)rng();
+		}
+	}
+}
+
+/**
+ * Times a kernel over rows of the same pixels.
+ * @param run Runs the kernel on one row.
+ * @return Nanoseconds per pixel.
+ */
+template<typename Run>
+double timeKernel(Run run)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BENCH_ROWS; ++i)
+	{
+		run();
+	}
+	auto time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	return time / ((double)BENCH_ROWS * BENCH_WIDTH);
+}
+
+/**
+ * Checks the palette expansion kernels of Zoom::blitPalettized() against
+ * the scalar one, for every width, color key and alignment, then times them.
+ * @param rng Random generator.
+ * @return True if all of them match.
+ */
+bool checkPaletteRowKernels(std::mt19937 &rng)
+{
+	auto kernels = ZoomKernels::getPaletteRowKernels();
+	const auto &reference = kernels.front();
+	Uint32 lut[256];
+	for (Uint32 &color : lut)
+	{
+		color = rng();
+	}
+
+	bool ok = true;
+	for (const auto &kernel : kernels)
+	{
+		int mismatches = 0;
+		for (int width : getWidths())
+		{
+			for (int colorKey : { -1, 0, 17, 255 })
+			{
+				for (int align = 0; align < 4; ++align)
+				{
+					std::vector<Uint8> src(width + align);
+					fillRow(rng, src, colorKey);
+					std::vector<Uint32> expected(width + align), actual;
+					for (Uint32 &pixel : expected)
+					{
+						pixel = rng();
+					}
+					actual = expected;
+					reference.func(src.data() + align, expected.data() + align, width, lut, colorKey);
+					kernel.func(src.data() + align, actual.data() + align, width, lut, colorKey);
+					if (expected != actual)
+					{
+						if (mismatches++ == 0)
+						{
+							std::printf("%s palette expansion differs: width %d, color key %d, alignment %d\n", kernel.name, width, colorKey, align);
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<Uint8> src(BENCH_WIDTH);
+		fillRow(rng, src, 0);
+		std::vector<Uint32> dst(BENCH_WIDTH);
+		double opaque = timeKernel([&]{ kernel.func(src.data(), dst.data(), BENCH_WIDTH, lut, -1); });
+		double keyed = timeKernel([&]{ kernel.func(src.data(), dst.data(), BENCH_WIDTH, lut, 0); });
+		std::printf("%-6s palette expansion: %s, %.3f ns/pixel, %.3f ns/pixel with a color key\n", kernel.name, mismatches ? "FAILED" : "ok", opaque, keyed);
+		ok = ok && mismatches == 0;
+	}
+	return ok;
+}
+
+/**
+ * Checks the shade kernels of Surface::blitNShade() against the scalar one,
+ * which uses the ShaderDraw helpers, then times them. Covers helper::StandardShade
+ * (no new color) and helper::ColorReplace (every color group), for every width,
+ * shade and alignment.
+ * @param rng Random generator.
+ * @return True if all of them match.
+ */
+bool checkShadeRowKernels(std::mt19937 &rng)
+{
+	auto kernels = ZoomKernels::getShadeRowKernels();
+	const auto &reference = kernels.front();
+
+	bool ok = true;
+	for (const auto &kernel : kernels)
+	{
+		int mismatches = 0;
+		for (int width : getWidths())
+		{
+			for (int newColor = -1; newColor < 16; ++newColor)
+			{
+				for (int shade = 0; shade <= 17; ++shade)
+				{
+					const int align = (width + shade) % 4;
+					const int color = newColor < 0 ? -1 : newColor * 16;
+					std::vector<Uint8> src(width + align);
+					fillRow(rng, src, 0);
+					std::vector<Uint8> expected(width + align), actual;
+					fillRow(rng, expected, -1);
+					actual = expected;
+					reference.func(expected.data() + align, src.data() + align, width, shade, color);
+					kernel.func(actual.data() + align, src.data() + align, width, shade, color);
+					if (expected != actual)
+					{
+						if (mismatches++ == 0)
+						{
+							std::printf("%s shade differs: width %d, shade %d, new color %d, alignment %d\n", kernel.name, width, shade, color, align);
+						}
+					}
+				}
+			}
+		}
+
+		std::vector<Uint8> src(BENCH_WIDTH);
+		fillRow(rng, src, 0);
+		std::vector<Uint8> dst(BENCH_WIDTH);
+		double standard = timeKernel([&]{ kernel.func(dst.data(), src.data(), BENCH_WIDTH, 4, -1); });
+		double replace = timeKernel([&]{ kernel.func(dst.data(), src.data(), BENCH_WIDTH, 4, 32); });
+		std::printf("%-6s shade: %s, %.3f ns/pixel, %.3f ns/pixel with a new color\n", kernel.name, mismatches ? "FAILED" : "ok", standard, replace);
+		ok = ok && mismatches == 0;
+	}
+	return ok;
+}
+
+}
+
+int main()
+{
+	std::mt19937 rng(20101);
+	bool ok = checkPaletteRowKernels(rng);
+	ok = checkShadeRowKernels(rng) && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,441 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ZoomKernels.h"
+#include "ShaderDraw.h"
+
+#if (_MSC_VER >= 1400) || (defined(__MINGW32__) && defined(__SSE2__))
+
+#ifndef __SSE2__
+#define __SSE2__ true
+#endif
+// probably Visual Studio (or Intel C++ which should also work)
+#include <intrin.h>
+#endif
+
+#ifdef __GNUC__
+#if (__i386__ || __x86_64__)
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#if (__i386__ || __x86_64__ || _M_IX86 || _M_X64) && !defined(__e2k__)
+#include <immintrin.h> // AVX2 kernels, only used when the CPU supports them
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace OpenXcom
+{
+
+/*
+ * Palette expansion kernels: convert a row of 8-bit pixels to 32-bit ones through a lookup table,
+ * optionally leaving the pixels of the color key untouched.
+ * All of them must give the same result as expandPaletteRowScalar(), zoomkernelcheck checks that they do.
+ */
+
+static void expandPaletteRowScalar(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey)
+{
+	if (colorKey < 0)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			dst[x] = lut[src[x]];
+		}
+	}
+	else
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			if (src[x] != colorKey)
+			{
+				dst[x] = lut[src[x]];
+			}
+		}
+	}
+}
+
+#ifdef __SSE2__
+/**
+ * SSE2 has no gather, so the lookups stay scalar, but whole 16 pixel runs of the color key
+ * are skipped with a single compare and the rest is merged with the destination without branching.
+ */
+static void expandPaletteRowSSE2(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey)
+{
+	int x = 0;
+	if (colorKey < 0)
+	{
+		for (; x + 4 <= width; x += 4)
+		{
+			const Uint8 *s = src + x;
+			_mm_storeu_si128((__m128i*)(dst + x), _mm_set_epi32(lut[s[3]], lut[s[2]], lut[s[1]], lut[s[0]]));
+		}
+	}
+	else
+	{
+		const __m128i key = _mm_set1_epi8((char)colorKey);
+		for (; x + 16 <= width; x += 16)
+		{
+			const Uint8 *s = src + x;
+			__m128i transparent = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)s), key);
+			if (_mm_movemask_epi8(transparent) == 0xFFFF)
+			{
+				continue;
+			}
+			// widen the byte mask to one 32-bit mask per pixel
+			__m128i lo = _mm_unpacklo_epi8(transparent, transparent);
+			__m128i hi = _mm_unpackhi_epi8(transparent, transparent);
+			__m128i masks[4] = { _mm_unpacklo_epi16(lo, lo), _mm_unpackhi_epi16(lo, lo), _mm_unpacklo_epi16(hi, hi), _mm_unpackhi_epi16(hi, hi) };
+			for (int i = 0; i < 4; ++i)
+			{
+				const Uint8 *p = s + i * 4;
+				__m128i *d = (__m128i*)(dst + x + i * 4);
+				__m128i color = _mm_set_epi32(lut[p[3]], lut[p[2]], lut[p[1]], lut[p[0]]);
+				_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(masks[i], color), _mm_and_si128(masks[i], _mm_loadu_si128(d))));
+			}
+		}
+	}
+	expandPaletteRowScalar(src + x, dst + x, width - x, lut, colorKey);
+}
+#endif
+
+#if defined(__GNUC__) && (__i386__ || __x86_64__) && !defined(__e2k__)
+#define ZOOM_AVX2_KERNEL __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define ZOOM_AVX2_KERNEL
+#endif
+
+#ifdef ZOOM_AVX2_KERNEL
+/**
+ * AVX2 looks up 8 pixels at once with a gather and masks out the color key on store.
+ */
+ZOOM_AVX2_KERNEL static void expandPaletteRowAVX2(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey)
+{
+	int x = 0;
+	const __m256i key = _mm256_set1_epi32(colorKey);
+	for (; x + 8 <= width; x += 8)
+	{
+		__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + x)));
+		__m256i color = _mm256_i32gather_epi32((const int*)lut, index, 4);
+		if (colorKey < 0)
+		{
+			_mm256_storeu_si256((__m256i*)(dst + x), color);
+		}
+		else
+		{
+			__m256i opaque = _mm256_xor_si256(_mm256_cmpeq_epi32(index, key), _mm256_set1_epi32(-1));
+			_mm256_maskstore_epi32((int*)(dst + x), opaque, color);
+		}
+	}
+	expandPaletteRowScalar(src + x, dst + x, width - x, lut, colorKey);
+}
+
+/**
+ * Checks if both the CPU and the OS support AVX2.
+ * @return Can AVX2 instructions be used?
+ */
+static bool haveAVX2()
+{
+#ifdef __GNUC__
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 1);
+	bool osxsave = (CPUInfo[2] & 0x08000000) != 0;
+	if (!osxsave || (_xgetbv(0) & 6) != 6)
+	{
+		return false;
+	}
+	__cpuidex(CPUInfo, 7, 0);
+	return (CPUInfo[1] & 0x00000020) != 0;
+#endif
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+/**
+ * NEON version of the SSE2 kernel: skips runs of the color key and merges the rest with the destination.
+ */
+static void expandPaletteRowNEON(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey)
+{
+	int x = 0;
+	const uint8x16_t key = vdupq_n_u8((Uint8)colorKey);
+	for (; x + 16 <= width; x += 16)
+	{
+		const Uint8 *s = src + x;
+		uint8x16_t transparent = vdupq_n_u8(0);
+		if (colorKey >= 0)
+		{
+			transparent = vceqq_u8(vld1q_u8(s), key);
+			if (vminvq_u8(transparent) == 0xFF)
+			{
+				continue;
+			}
+		}
+		// widen the byte mask to one 32-bit mask per pixel
+		uint8x16x2_t b = vzipq_u8(transparent, transparent);
+		uint16x8x2_t lo = vzipq_u16(vreinterpretq_u16_u8(b.val[0]), vreinterpretq_u16_u8(b.val[0]));
+		uint16x8x2_t hi = vzipq_u16(vreinterpretq_u16_u8(b.val[1]), vreinterpretq_u16_u8(b.val[1]));
+		const uint32x4_t masks[4] = { vreinterpretq_u32_u16(lo.val[0]), vreinterpretq_u32_u16(lo.val[1]), vreinterpretq_u32_u16(hi.val[0]), vreinterpretq_u32_u16(hi.val[1]) };
+		for (int i = 0; i < 16; i += 4)
+		{
+			const uint32_t colors[4] = { lut[s[i]], lut[s[i + 1]], lut[s[i + 2]], lut[s[i + 3]] };
+			uint32x4_t color = vld1q_u32(colors);
+			if (colorKey >= 0)
+			{
+				color = vbslq_u32(masks[i / 4], vld1q_u32(dst + x + i), color);
+			}
+			vst1q_u32(dst + x + i, color);
+		}
+	}
+	expandPaletteRowScalar(src + x, dst + x, width - x, lut, colorKey);
+}
+#endif
+
+/*
+ * Shade kernels: blit a row of 8-bit sprite pixels onto a surface row with a shade offset
+ * and optionally a new color group, leaving the destination untouched under transparent pixels.
+ * All of them must give the same result as shadeRowScalar(), which uses the ShaderDraw helpers;
+ * zoomkernelcheck checks that they do.
+ */
+
+static void shadeRowScalar(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor)
+{
+	if (newColor < 0)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			helper::StandardShade::func(dest[x], src[x], shade);
+		}
+	}
+	else
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			helper::ColorReplace::func(dest[x], src[x], shade, newColor);
+		}
+	}
+}
+
+#ifdef __SSE2__
+/**
+ * SSE2 shades 16 pixels at once and skips runs that are fully transparent.
+ */
+static void shadeRowSSE2(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor)
+{
+	int x = 0;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i group = _mm_set1_epi8((char)helper::ColorGroup);
+	const __m128i black = _mm_set1_epi8((char)helper::ColorShade);
+	const __m128i offset = _mm_set1_epi8((char)shade);
+	const __m128i color = _mm_set1_epi8((char)newColor);
+	for (; x + 16 <= width; x += 16)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + x));
+		__m128i transparent = _mm_cmpeq_epi8(s, zero);
+		if (_mm_movemask_epi8(transparent) == 0xFFFF)
+		{
+			continue;
+		}
+		__m128i shaded, valid;
+		if (newColor < 0)
+		{
+			// too dark when the shade flips over to another color group
+			shaded = _mm_add_epi8(s, offset);
+			valid = _mm_cmpeq_epi8(_mm_and_si128(_mm_xor_si128(shaded, s), group), zero);
+		}
+		else
+		{
+			shaded = _mm_add_epi8(_mm_and_si128(s, black), offset);
+			valid = _mm_cmpeq_epi8(_mm_and_si128(shaded, group), zero);
+			shaded = _mm_or_si128(shaded, color);
+		}
+		shaded = _mm_or_si128(_mm_and_si128(valid, shaded), _mm_andnot_si128(valid, black));
+		__m128i *d = (__m128i*)(dest + x);
+		_mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(transparent, _mm_loadu_si128(d)), _mm_andnot_si128(transparent, shaded)));
+	}
+	shadeRowScalar(dest + x, src + x, width - x, shade, newColor);
+}
+#endif
+
+#ifdef ZOOM_AVX2_KERNEL
+/**
+ * AVX2 version of the SSE2 kernel, 32 pixels at once.
+ */
+ZOOM_AVX2_KERNEL static void shadeRowAVX2(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor)
+{
+	int x = 0;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i group = _mm256_set1_epi8((char)helper::ColorGroup);
+	const __m256i black = _mm256_set1_epi8((char)helper::ColorShade);
+	const __m256i offset = _mm256_set1_epi8((char)shade);
+	const __m256i color = _mm256_set1_epi8((char)newColor);
+	for (; x + 32 <= width; x += 32)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(src + x));
+		__m256i transparent = _mm256_cmpeq_epi8(s, zero);
+		if (_mm256_movemask_epi8(transparent) == -1)
+		{
+			continue;
+		}
+		__m256i shaded, valid;
+		if (newColor < 0)
+		{
+			shaded = _mm256_add_epi8(s, offset);
+			valid = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_xor_si256(shaded, s), group), zero);
+		}
+		else
+		{
+			shaded = _mm256_add_epi8(_mm256_and_si256(s, black), offset);
+			valid = _mm256_cmpeq_epi8(_mm256_and_si256(shaded, group), zero);
+			shaded = _mm256_or_si256(shaded, color);
+		}
+		shaded = _mm256_blendv_epi8(black, shaded, valid);
+		__m256i *d = (__m256i*)(dest + x);
+		_mm256_storeu_si256(d, _mm256_blendv_epi8(shaded, _mm256_loadu_si256(d), transparent));
+	}
+	shadeRowScalar(dest + x, src + x, width - x, shade, newColor);
+}
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+/**
+ * NEON version of the SSE2 kernel.
+ */
+static void shadeRowNEON(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor)
+{
+	int x = 0;
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t group = vdupq_n_u8(helper::ColorGroup);
+	const uint8x16_t black = vdupq_n_u8(helper::ColorShade);
+	const uint8x16_t offset = vdupq_n_u8((Uint8)shade);
+	const uint8x16_t color = vdupq_n_u8((Uint8)newColor);
+	for (; x + 16 <= width; x += 16)
+	{
+		uint8x16_t s = vld1q_u8(src + x);
+		uint8x16_t transparent = vceqq_u8(s, zero);
+		if (vminvq_u8(transparent) == 0xFF)
+		{
+			continue;
+		}
+		uint8x16_t shaded, valid;
+		if (newColor < 0)
+		{
+			shaded = vaddq_u8(s, offset);
+			valid = vceqq_u8(vandq_u8(veorq_u8(shaded, s), group), zero);
+		}
+		else
+		{
+			shaded = vaddq_u8(vandq_u8(s, black), offset);
+			valid = vceqq_u8(vandq_u8(shaded, group), zero);
+			shaded = vorrq_u8(shaded, color);
+		}
+		shaded = vbslq_u8(valid, shaded, black);
+		vst1q_u8(dest + x, vbslq_u8(transparent, vld1q_u8(dest + x), shaded));
+	}
+	shadeRowScalar(dest + x, src + x, width - x, shade, newColor);
+}
+#endif
+
+/**
+ * Checks the SSE2 feature bit returned by the CPUID instruction
+ * @return Does the CPU support SSE2?
+ */
+bool ZoomKernels::haveSSE2()
+{
+#ifndef __SSE2__
+	return false;
+#else
+#ifdef __GNUC__
+	unsigned int CPUInfo[4] = {0, 0, 0, 0};
+	#if (__e2k__) // e2k - MCST Elbrus 2000 architecture
+		#ifdef __SSE2__
+			CPUInfo[3] = 0x04000000;
+		#endif
+	#else // i386/x86_64
+		__get_cpuid(1, CPUInfo, CPUInfo+1, CPUInfo+2, CPUInfo+3);
+	#endif
+#elif _WIN32
+	int CPUInfo[4];
+	__cpuid(CPUInfo, 1);
+#else
+	unsigned int CPUInfo[4] = {0, 0, 0, 0};
+#endif
+
+	return (CPUInfo[3] & 0x04000000) ? true : false;
+#endif
+}
+
+/**
+ * Gets the palette expansion kernels the CPU supports.
+ * @return Kernels, the scalar one first and the fastest last.
+ */
+std::vector<ZoomKernels::Kernel<ZoomKernels::PaletteRow>> ZoomKernels::getPaletteRowKernels()
+{
+	std::vector<Kernel<PaletteRow>> kernels = { { "scalar", expandPaletteRowScalar } };
+#if defined(__aarch64__) && defined(__ARM_NEON)
+	kernels.push_back({ "NEON", expandPaletteRowNEON });
+#endif
+#ifdef __SSE2__
+	if (haveSSE2())
+	{
+		kernels.push_back({ "SSE2", expandPaletteRowSSE2 });
+	}
+#endif
+#ifdef ZOOM_AVX2_KERNEL
+	if (haveAVX2())
+	{
+		kernels.push_back({ "AVX2", expandPaletteRowAVX2 });
+	}
+#endif
+	return kernels;
+}
+
+/**
+ * Gets the shade kernels the CPU supports.
+ * @return Kernels, the scalar one first and the fastest last.
+ */
+std::vector<ZoomKernels::Kernel<ZoomKernels::ShadeRow>> ZoomKernels::getShadeRowKernels()
+{
+	std::vector<Kernel<ShadeRow>> kernels = { { "scalar", shadeRowScalar } };
+#if defined(__aarch64__) && defined(__ARM_NEON)
+	kernels.push_back({ "NEON", shadeRowNEON });
+#endif
+#ifdef __SSE2__
+	if (haveSSE2())
+	{
+		kernels.push_back({ "SSE2", shadeRowSSE2 });
+	}
+#endif
+#ifdef ZOOM_AVX2_KERNEL
+	if (haveAVX2())
+	{
+		kernels.push_back({ "AVX2", shadeRowAVX2 });
+	}
+#endif
+	return kernels;
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Row kernels used by Zoom to blit 8-bit pixels, in plain C++ and
+ * vectorized for the instruction sets the compiler supports.
+ * They are kept apart from the rest of the engine, so zoomkernelcheck
+ * can compare every kernel the CPU supports with the scalar one.
+ * The half-transparency blends (Mod::getLUTs()) have no kernel here: each pixel
+ * is a lookup in a 256-entry table, which SSE2, AVX2 and NEON cannot do faster
+ * than the scalar loop.
+ */
+class ZoomKernels
+{
+public:
+	/// Converts a row of 8-bit pixels to 32-bit ones through a palette lookup table.
+	typedef void (*PaletteRow)(const Uint8 *src, Uint32 *dst, int width, const Uint32 *lut, int colorKey);
+	/// Blits a row of 8-bit sprite pixels with a shade offset.
+	typedef void (*ShadeRow)(Uint8 *dest, const Uint8 *src, int width, int shade, int newColor);
+
+	/// A kernel and the name of its instruction set.
+	template<typename Func>
+	struct Kernel
+	{
+		const char *name;
+		Func func;
+	};
+
+	/// Check for SSE2 instructions using CPUID.
+	static bool haveSSE2();
+	/// Gets the palette expansion kernels the CPU supports, from the scalar one to the fastest.
+	static std::vector<Kernel<PaletteRow>> getPaletteRowKernels();
+	/// Gets the shade kernels the CPU supports, from the scalar one to the fastest.
+	static std::vector<Kernel<ShadeRow>> getShadeRowKernels();
+};
+
+}
@@ -509,6 +509,27 @@ void GeoscapeState::blit()
 	}
 }
 
+/**
+ * Checks if the geoscape or any of the dogfights
+ * on top of it will be redrawn on the next blit.
+ * @return True if a surface is waiting to be redrawn.
+ */
+bool GeoscapeState::isRedrawPending() const
+{
+	if (State::isRedrawPending())
+	{
+		return true;
+	}
+	for (auto* dfs : _dogfights)
+	{
+		if (dfs->isRedrawPending())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 /**
  * Handle key shortcuts.
  * @param action Pointer to an action.
@@ -819,8 +840,7 @@ void GeoscapeState::timeAdvance()
 			_slowdownCounter--;
 			if (_slowdownCounter > 0)
 			{
-				// wait
-				_globe->draw();
+				// wait, nothing on the globe moved
 				return;
 			}
 			else
@@ -852,8 +872,10 @@ void GeoscapeState::timeAdvance()
 	}
 
 
+	bool advanced = false;
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
+		advanced = true;
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
 		switch (trigger)
@@ -881,7 +903,11 @@ void GeoscapeState::timeAdvance()
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
 
 	timeDisplay();
-	_globe->draw();
+	// the globe only changes when time passes, rotating and blinking redraw it on their own
+	if (advanced)
+	{
+		_globe->draw();
+	}
 }
 
 /**
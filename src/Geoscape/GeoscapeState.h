@@ -164,6 +164,8 @@ public:
 	void btnZoomOutRightClick(Action *action);
 	/// Blit method - renders the state and dogfights.
 	void blit() override;
+	/// Checks if the geoscape or a dogfight will be redrawn.
+	bool isRedrawPending() const override;
 	/// Globe zoom in effect for dogfights.
 	void zoomInEffect();
 	/// Globe zoom out effect for dogfights.
@@ -53,6 +53,7 @@
 #include "../Mod/Texture.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -950,6 +951,7 @@ void Globe::rotate()
  */
 void Globe::draw()
 {
+	FrameProfilerScope profile(FRAME_GLOBE);
 	if (_redraw)
 	{
 		cachePolygons();
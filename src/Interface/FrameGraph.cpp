@@ -0,0 +1,239 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameGraph.h"
+#include <algorithm>
+#include <climits>
+#include <iomanip>
+#include <sstream>
+#include "Text.h"
+#include "../Engine/Action.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Options.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Colors of the frame sections, matched to the closest palette entry.
+const SDL_Color SECTION_COLORS[FRAME_SECTIONS] =
+{
+	{ 255, 255, 0, 255 },	// events
+	{ 0, 255, 0, 255 },		// think
+	{ 0, 128, 255, 255 },	// blit
+	{ 128, 64, 0, 255 },	// terrain
+	{ 0, 255, 255, 255 },	// globe
+	{ 255, 0, 255, 255 },	// zoom
+	{ 255, 0, 0, 255 },		// flip
+};
+/// Colors alternating between the blits of the states, drawn over the blit section.
+const SDL_Color STATE_COLORS[2] = { { 0, 64, 192, 255 }, { 128, 192, 255, 255 } };
+const SDL_Color IDLE_COLOR = { 64, 64, 64, 255 };
+const SDL_Color TARGET_COLOR = { 255, 255, 255, 255 };
+
+/**
+ * Finds the palette entry closest to a color.
+ * Entry 0 is skipped since it's transparent.
+ */
+Uint8 findClosestColor(const SDL_Color *palette, const SDL_Color &color)
+{
+	Uint8 best = 1;
+	int bestDistance = INT_MAX;
+	for (int i = 1; i < 256; ++i)
+	{
+		int r = palette[i].r - color.r;
+		int g = palette[i].g - color.g;
+		int b = palette[i].b - color.b;
+		int distance = r * r + g * g + b * b;
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			best = i;
+		}
+	}
+	return best;
+}
+
+}
+
+/**
+ * Creates a frame graph of the specified size, hidden by default.
+ * @param width Width in pixels, one column per frame.
+ * @param height Height in pixels.
+ * @param x X position in pixels.
+ * @param y Y position in pixels.
+ */
+FrameGraph::FrameGraph(int width, int height, int x, int y) : Surface(width, height, x, y), _idleColor(1), _targetColor(1)
+{
+	std::fill(std::begin(_colors), std::end(_colors), 1);
+	std::fill(std::begin(_stateColors), std::end(_stateColors), 1);
+	_visible = false;
+	_label = new Text(width, 9, 0, 0);
+}
+
+/**
+ * Deletes the state label.
+ */
+FrameGraph::~FrameGraph()
+{
+	delete _label;
+}
+
+/**
+ * Replaces a certain amount of colors in the frame graph palette,
+ * and picks the closest colors for each section.
+ * @param colors Pointer to the set of colors.
+ * @param firstcolor Offset of the first color to replace.
+ * @param ncolors Amount of colors to replace.
+ */
+void FrameGraph::setPalette(const SDL_Color *colors, int firstcolor, int ncolors)
+{
+	Surface::setPalette(colors, firstcolor, ncolors);
+	const SDL_Color *palette = getPalette();
+	for (int i = 0; i < FRAME_SECTIONS; ++i)
+	{
+		_colors[i] = findClosestColor(palette, SECTION_COLORS[i]);
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		_stateColors[i] = findClosestColor(palette, STATE_COLORS[i]);
+	}
+	_idleColor = findClosestColor(palette, IDLE_COLOR);
+	_targetColor = findClosestColor(palette, TARGET_COLOR);
+	_label->setPalette(colors, firstcolor, ncolors);
+	_label->setColor(_targetColor);
+	_redraw = true;
+}
+
+/**
+ * Initializes the fonts of the state label.
+ * @param big Pointer to large-size font.
+ * @param small Pointer to small-size font.
+ * @param lang Pointer to current language.
+ */
+void FrameGraph::initText(Font *big, Font *small, Language *lang)
+{
+	_label->initText(big, small, lang);
+	_redraw = true;
+}
+
+/**
+ * Shows / hides the frame graph, or saves the recorded
+ * frames to a CSV file when CTRL is pressed.
+ * @param action Pointer to an action.
+ */
+void FrameGraph::handle(Action *action)
+{
+	if (action->getDetails()->type == SDL_KEYDOWN && action->getDetails()->key.keysym.sym == Options::keyFrameProfiler)
+	{
+		if ((SDL_GetModState() & KMOD_CTRL) != 0)
+		{
+			std::ostringstream ss;
+			int i = 0;
+			do
+			{
+				ss.str("");
+				ss << Options::getMasterUserFolder() << "frames" << std::setfill('0') << std::setw(3) << i << ".csv";
+				i++;
+			}
+			while (CrossPlatform::fileExists(ss.str()));
+			Profiler::saveFrames(ss.str());
+		}
+		else
+		{
+			_visible = !_visible;
+		}
+	}
+}
+
+/**
+ * Draws one column per frame, newest on the right, stacking
+ * the frame sections from the bottom up. Nested sections were
+ * already taken out of the section they ran in, so each one is
+ * a bar of its own and the rest of the frame is idle time.
+ * The blits of the states follow the blit section in alternating
+ * colors, the one taking the longest in the newest frame is named.
+ * The line marks the time of a frame at the FPS limit.
+ */
+void FrameGraph::draw()
+{
+	Surface::draw();
+	int frames = std::min(getWidth(), Profiler::getFrameCount());
+	int height = getHeight();
+	auto toPixels = [](Uint32 us) { return (int)(us * PIXELS_PER_MS / 1000); };
+	for (int age = 0; age < frames; ++age)
+	{
+		const FrameTimes &frame = Profiler::getFrame(age);
+		int x = getWidth() - 1 - age;
+		int y = height;
+		auto bar = [&](int pixels, Uint8 color)
+		{
+			pixels = std::min(pixels, y);
+			if (pixels > 0)
+			{
+				y -= pixels;
+				drawRect(x, y, 1, pixels, color);
+			}
+		};
+		int total = toPixels(frame.total);
+		for (int section = 0; section < FRAME_SECTIONS; ++section)
+		{
+			bar(toPixels(frame.sections[section]), _colors[section]);
+			if (section == FRAME_BLIT)
+			{
+				for (int i = 0; i < frame.stateCount; ++i)
+				{
+					bar(toPixels(frame.states[i].time), _stateColors[i % 2]);
+				}
+			}
+		}
+		bar(total - (height - y), _idleColor);
+	}
+	if (frames > 0)
+	{
+		const FrameTimes &frame = Profiler::getFrame(0);
+		const FrameStateTime *slowest = nullptr;
+		for (int i = 0; i < frame.stateCount; ++i)
+		{
+			if (!slowest || frame.states[i].time > slowest->time)
+			{
+				slowest = &frame.states[i];
+			}
+		}
+		if (slowest)
+		{
+			std::ostringstream ss;
+			ss << slowest->name << ' ' << std::fixed << std::setprecision(1) << slowest->time / 1000.0 << "ms";
+			_label->setText(ss.str());
+			_label->blit(getSurface());
+		}
+	}
+	if (Options::FPS > 0)
+	{
+		int target = height - PIXELS_PER_MS * 1000 / Options::FPS;
+		if (target >= 0)
+		{
+			drawRect(0, target, getWidth(), 1, _targetColor);
+		}
+	}
+}
+
+}
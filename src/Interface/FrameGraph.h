@@ -0,0 +1,55 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "../Engine/Surface.h"
+#include "../Engine/Profiler.h"
+
+namespace OpenXcom
+{
+
+class Action;
+class Text;
+
+/**
+ * Overlay graph of the frame profiler, showing the time
+ * spent in each part of the latest frames as stacked bars,
+ * and which state took the longest to blit in the latest one.
+ */
+class FrameGraph : public Surface
+{
+private:
+	static const int PIXELS_PER_MS = 2;
+	Uint8 _colors[FRAME_SECTIONS], _stateColors[2], _idleColor, _targetColor;
+	Text *_label;
+public:
+	/// Creates a new frame graph.
+	FrameGraph(int width, int height, int x, int y);
+	/// Cleans up the frame graph.
+	~FrameGraph();
+	/// Sets the frame graph's palette.
+	void setPalette(const SDL_Color *colors, int firstcolor = 0, int ncolors = 256) override;
+	/// Initializes the resources for the state label.
+	void initText(Font *big, Font *small, Language *lang) override;
+	/// Handles keyboard events.
+	void handle(Action *action);
+	/// Draws the frame graph.
+	void draw() override;
+};
+
+}
@@ -34,6 +34,10 @@
 #include "../Engine/Options.h"
 #include "../Engine/FileMap.h"
 #include "../Engine/SDL2Helpers.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
+#include "LoadGameState.h"
+#include "../Battlescape/BattleReplay.h"
 #include <fstream>
 
 namespace OpenXcom
@@ -198,6 +202,20 @@ MainMenuState::MainMenuState(bool updateCheck)
 void MainMenuState::init()
 {
 	State::init();
+	if (!Options::oxceBattleReplay.empty())
+	{
+		// play the replay once, it is not saved in the options
+		std::string replay = Options::oxceBattleReplay;
+		Options::oxceBattleReplay = "";
+		if (CrossPlatform::fileExists(Options::getMasterUserFolder() + replay + ".rsav"))
+		{
+			Log(LOG_INFO) << "Loading replay " << replay;
+			BattleReplay::setNext(replay);
+			_game->pushState(new LoadGameState(OPT_MENU, replay + ".rsav", _palette));
+			return;
+		}
+		Log(LOG_ERROR) << "Replay " << replay << " not found.";
+	}
 	if (Options::getLoadLastSave() && _game->getSavedGame()->getList(_game->getLanguage(), true).size() > 0)
 	{
 		Log(LOG_INFO) << "Loading last saved game";
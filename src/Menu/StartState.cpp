@@ -30,6 +30,7 @@
 #include "../Engine/Font.h"
 #include "../Engine/Timer.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/Profiler.h"
 #include "../Interface/FpsCounter.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/Text.h"
@@ -312,6 +313,7 @@ int StartState::load(void *game_ptr)
 		Log(LOG_INFO) << "Loading language...";
 		game->loadLanguages();
 		Log(LOG_INFO) << "Language loaded successfully.";
+		Profiler::saveTrace();
 		loading = LOADING_SUCCESSFUL;
 	}
 	catch (std::exception &e)
@@ -421,7 +421,7 @@ void TestState::testCase3()
 		for (size_t i = 0; i < tagValues.size(); ++i)
 		{
 			auto nameAsString = tagNames.values[i].name.toString().substr(4);
-			tagMatrix[armorRule][nameAsString] = tagValues.at(i);
+			tagMatrix[armorRule][nameAsString] = tagValues.begin()[i];
 		}
 	}
 
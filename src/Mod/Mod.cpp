@@ -48,10 +48,13 @@
 #include "CustomPalettes.h"
 #include "ExtraSounds.h"
 #include "../Engine/AdlibMusic.h"
+#include "../Engine/SDL2Helpers.h"
 #include "../Engine/CatFile.h"
 #include "../fmath.h"
+#include "../md5.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Battlescape/Pathfinding.h"
 #include "RuleCountry.h"
 #include "RuleRegion.h"
@@ -2016,6 +2019,7 @@ static void throwModOnErrorHelper(const std::string& modId, const std::string& e
  */
 void Mod::loadAll()
 {
+	ProfilerScope profile("mod", "Mod::loadAll");
 	ModScript parser{ _scriptGlobal, this };
 	const auto& mods = FileMap::getRulesets();
 
@@ -2094,6 +2098,8 @@ void Mod::loadAll()
 		{
 			_modCurrent = &_modData.at(i);
 			_scriptGlobal->setMod((int)_modCurrent->offset);
+			_scriptGlobal->setCurrentMod(_modCurrent->name);
+			ProfilerScope profileMod("mod", "Mod::loadMod", _modCurrent->name);
 			loadMod(mods[i].second, parser);
 		}
 		catch (Exception &e)
@@ -2106,6 +2112,7 @@ void Mod::loadAll()
 
 	//back master
 	_modCurrent = &_modData.at(0);
+	_scriptGlobal->setCurrentMod(_modCurrent->name);
 	_scriptGlobal->endLoad();
 
 	// post-processing item categories
@@ -2151,6 +2158,7 @@ void Mod::loadAll()
 
 
 	Log(LOG_INFO) << "After load.";
+	ProfilerScope profileAfterLoad("mod", "Mod::afterLoad");
 	// cross link rule objects
 
 	afterLoadHelper("research", this, _research, &RuleResearch::afterLoad);
@@ -2563,6 +2571,7 @@ void Mod::loadConstants(const YAML::Node &node)
  */
 void Mod::loadFile(const FileMap::FileRecord &filerec, ModScript &parsers)
 {
+	ProfilerScope profile("mod", "Mod::loadFile", filerec.fullpath);
 	auto doc = filerec.getYAML();
 
 	auto loadDocInfoHelper = [&](const char* nodeName)
@@ -4760,6 +4769,7 @@ struct compareSection
  */
 void Mod::sortLists()
 {
+	ProfilerScope profile("mod", "Mod::sortLists");
 	for (auto rulePair : _ufopaediaArticles)
 	{
 		auto rule = rulePair.second;
@@ -5164,6 +5174,7 @@ namespace
  */
 void Mod::loadVanillaResources()
 {
+	ProfilerScope profile("mod", "Mod::loadVanillaResources");
 	// Create Geoscape surface
 	_sets["GlobeMarkers"] = new SurfaceSet(3, 3);
 	// dummy resources, that need to be defined in order for mod loading to work correctly
@@ -5756,6 +5767,7 @@ void Mod::loadBattlescapeResources()
  */
 void Mod::loadExtraResources()
 {
+	ProfilerScope profile("mod", "Mod::loadExtraResources");
 	// Load fonts
 	YAML::Node doc = FileMap::getYAML("Language/" + _fontName);
 	Log(LOG_INFO) << "Loading fonts... " << _fontName;
@@ -5923,6 +5935,7 @@ void Mod::loadExtraResources()
 			createTransparencyLUT(_palettes["PAL_BATTLESCAPE_3"]);
 		}
 	}
+	pruneTransparencyLUTCache();
 
 	TextButton::soundPress = getSound("GEO.CAT", Mod::BUTTON_PRESS);
 	Window::soundPopup[0] = getSound("GEO.CAT", Mod::WINDOW_POPUP[0]);
@@ -5978,6 +5991,7 @@ void Mod::loadExtraSprite(ExtraSprites *spritePack)
  */
 void Mod::modResources()
 {
+	ProfilerScope profile("mod", "Mod::modResources");
 	// we're gonna need these
 	getSurface("GEOBORD.SCR");
 	getSurface("ALTGEOBORD.SCR", false);
@@ -6162,6 +6176,139 @@ Music* Mod::loadMusic(MusicFormat fmt, RuleMusic* rule, CatFile* adlibcat, CatFi
 	return music;
 }
 
+namespace
+{
+
+/**
+ * Nearest color search in a palette, accelerated by a coarse RGB cube.
+ * Each cube cell lazily collects the palette entries that can be the closest
+ * match for any color inside it, so a query only tests a few candidates
+ * instead of the whole palette. Results are identical to a brute force search,
+ * ties included (lowest index wins).
+ */
+class PaletteNearestColor
+{
+	/// Number of bits of each color channel used to select a cell.
+	static constexpr int CellBits = 4;
+	static constexpr int CellsPerChannel = 1 << CellBits;
+	static constexpr int CellSize = 256 / CellsPerChannel;
+
+	const SDL_Color* _colors;
+	int _first, _last;
+	std::vector<std::vector<Uint8>> _cells;
+	std::vector<bool> _cellsReady;
+
+	/// Squared distance from channel value to closest and farthest point of range.
+	static void channelDistance(int v, int low, int &minDist, int &maxDist)
+	{
+		const int high = low + CellSize - 1;
+		const int d = v < low ? low - v : v > high ? v - high : 0;
+		minDist += d * d;
+		const int f = std::max(std::abs(v - low), std::abs(v - high));
+		maxDist += f * f;
+	}
+
+	/// Finds all palette entries that could be closest for any color in a given cell.
+	void buildCell(int r, int g, int b, std::vector<Uint8> &cell) const
+	{
+		const int lowR = r * CellSize, lowG = g * CellSize, lowB = b * CellSize;
+		int minDist[256];
+		int threshold = INT_MAX;
+		for (int i = _first; i < _last; ++i)
+		{
+			int maxDist = 0;
+			minDist[i] = 0;
+			channelDistance(_colors[i].r, lowR, minDist[i], maxDist);
+			channelDistance(_colors[i].g, lowG, minDist[i], maxDist);
+			channelDistance(_colors[i].b, lowB, minDist[i], maxDist);
+			threshold = std::min(threshold, maxDist);
+		}
+		for (int i = _first; i < _last; ++i)
+		{
+			if (minDist[i] <= threshold)
+			{
+				cell.push_back(i);
+			}
+		}
+	}
+
+public:
+	/**
+	 * Creates a search structure over a range of palette entries.
+	 * @param colors Palette colors, need to outlive this object.
+	 * @param first First entry that can be matched.
+	 * @param last One past the last entry that can be matched.
+	 */
+	PaletteNearestColor(const SDL_Color* colors, int first, int last) :
+		_colors(colors), _first(first), _last(last),
+		_cells(CellsPerChannel * CellsPerChannel * CellsPerChannel),
+		_cellsReady(_cells.size(), false)
+	{
+
+	}
+
+	/**
+	 * Gets the palette entry closest to the given color.
+	 */
+	Uint8 find(Uint8 r, Uint8 g, Uint8 b)
+	{
+		const int cr = r >> (8 - CellBits), cg = g >> (8 - CellBits), cb = b >> (8 - CellBits);
+		const size_t index = (cr * CellsPerChannel + cg) * CellsPerChannel + cb;
+		auto& cell = _cells[index];
+		if (!_cellsReady[index])
+		{
+			buildCell(cr, cg, cb, cell);
+			_cellsReady[index] = true;
+		}
+
+		Uint8 closest = _first;
+		int lowestDifference = INT_MAX;
+		for (Uint8 comparator : cell)
+		{
+			int currentDifference = Sqr(r - _colors[comparator].r) +
+				Sqr(g - _colors[comparator].g) +
+				Sqr(b - _colors[comparator].b);
+
+			if (currentDifference < lowestDifference)
+			{
+				closest = comparator;
+				lowestDifference = currentDifference;
+			}
+		}
+		return closest;
+	}
+};
+
+/// Version of transparency LUT cache files, change when the layout or algorithm changes.
+const char TransparencyLUTCacheVersion[] = "oxce-transparency-lut-1";
+
+} // namespace
+
+/**
+ * Gets the name of the file used to cache transparency LUT for given palette and the current transparency rules.
+ * @param palColors Palette colors.
+ * @return Full path to cache file.
+ */
+std::string Mod::getTransparencyLUTCacheFile(const SDL_Color* palColors) const
+{
+	MD5 hash;
+	hash.update(TransparencyLUTCacheVersion, sizeof(TransparencyLUTCacheVersion));
+	for (int currentColor = 0; currentColor < TransparenciesPaletteColors; ++currentColor)
+	{
+		const unsigned char c[3] = { palColors[currentColor].r, palColors[currentColor].g, palColors[currentColor].b };
+		hash.update(c, sizeof(c));
+	}
+	for (const auto& tintLevels : _transparencies)
+	{
+		for (const SDL_Color& tint : tintLevels)
+		{
+			const unsigned char c[4] = { tint.r, tint.g, tint.b, tint.unused };
+			hash.update(c, sizeof(c));
+		}
+	}
+	return Options::getCacheFolder() + "transparency_" + hash.finalize().hexdigest() + ".lut";
+}
+
 /**
  * Preamble:
  * this is the most horrible function i've ever written, and it makes me sad.
@@ -6169,14 +6316,40 @@ Music* Mod::loadMusic(MusicFormat fmt, RuleMusic* rule, CatFile* adlibcat, CatFi
  * when used with the default TFTD mod, this function loops 4,194,304 times
  * (4 palettes, 4 tints, 4 levels of opacity, 256 colors, 256 comparisons per)
  * each additional tint in the rulesets will result in over a million iterations more.
+ * Today the closest color search only checks a few candidates from an RGB cube,
+ * and finished tables are cached on disk, so usually there is no work to do at all.
  * @param pal the palette to base the lookup table on.
  */
 void Mod::createTransparencyLUT(Palette *pal)
 {
 	const SDL_Color* palColors = pal->getColors(0);
+	const size_t expectedSize = _transparencies.size() * TransparenciesPaletteColors * TransparenciesOpacityLevels;
+	std::string cacheFile;
+	if (Options::oxceDiskCache && CrossPlatform::folderExists(Options::getCacheFolder()))
+	{
+		cacheFile = getTransparencyLUTCacheFile(palColors);
+		_transparencyLUTCacheFiles.push_back(cacheFile);
+		if (CrossPlatform::fileExists(cacheFile))
+		{
+			SDL_RWops *rw = SDL_RWFromFile(cacheFile.c_str(), "rb");
+			size_t size = 0;
+			Uint8 *data = rw ? (Uint8 *)SDL_LoadFile_RW(rw, &size, SDL_TRUE) : nullptr;
+			if (data && size == expectedSize)
+			{
+				Log(LOG_VERBOSE) << "Transparency LUT loaded from cache: " << cacheFile;
+				_transparencyLUTs.push_back(std::vector<Uint8>(data, data + size));
+				SDL_free(data);
+				return;
+			}
+			Log(LOG_WARNING) << "Ignoring invalid transparency LUT cache file: " << cacheFile;
+			SDL_free(data);
+		}
+	}
+
+	PaletteNearestColor nearest(palColors, 1, TransparenciesPaletteColors);
 	std::vector<Uint8> lookUpTable;
 	// start with the color sets
-	lookUpTable.reserve(_transparencies.size() * TransparenciesPaletteColors * TransparenciesOpacityLevels);
+	lookUpTable.reserve(expectedSize);
 	for (const auto& tintLevels : _transparencies)
 	{
 		// then the opacity levels, using the alpha channel as the step
@@ -6192,31 +6365,54 @@ void Mod::createTransparencyLUT(Palette *pal)
 				desiredColor.b = std::min(255, (palColors[currentColor].b * tint.unused / 255) + tint.b);
 
 				Uint8 closest = currentColor;
-				int lowestDifference = INT_MAX;
 				// if opacity is zero then we stay with current color, transparent color will stay same too
 				if (tint.unused != 0 && currentColor != 0)
 				{
-					// now compare each color in the palette to find the closest match to our desired one
-					for (int comparator = 1; comparator < TransparenciesPaletteColors; ++comparator)
-					{
-						int currentDifference = Sqr(desiredColor.r - palColors[comparator].r) +
-							Sqr(desiredColor.g - palColors[comparator].g) +
-							Sqr(desiredColor.b - palColors[comparator].b);
-
-						if (currentDifference < lowestDifference)
-						{
-							closest = comparator;
-							lowestDifference = currentDifference;
-						}
-					}
+					// now find the closest match to our desired one
+					closest = nearest.find(desiredColor.r, desiredColor.g, desiredColor.b);
 				}
 				lookUpTable.push_back(closest);
 			}
 		}
 	}
+	if (!cacheFile.empty())
+	{
+		CrossPlatform::writeFile(cacheFile, lookUpTable);
+	}
 	_transparencyLUTs.push_back(std::move(lookUpTable));
 }
 
+/**
+ * Deletes the transparency lookup tables in the cache folder that were not
+ * used by the current mods, so tables of old palettes and rules don't pile up.
+ */
+void Mod::pruneTransparencyLUTCache() const
+{
+	if (!Options::oxceDiskCache || _transparencyLUTCacheFiles.empty())
+	{
+		return;
+	}
+	const std::string &cacheDir = Options::getCacheFolder();
+	for (const auto &entry : CrossPlatform::getFolderContents(cacheDir, "lut"))
+	{
+		const std::string &name = std::get<0>(entry);
+		std::string file = cacheDir + name;
+		if (std::get<1>(entry) || name.compare(0, 13, "transparency_") != 0
+			|| std::find(_transparencyLUTCacheFiles.begin(), _transparencyLUTCacheFiles.end(), file) != _transparencyLUTCacheFiles.end())
+		{
+			continue;
+		}
+		if (CrossPlatform::deleteFile(file))
+		{
+			Log(LOG_VERBOSE) << "Deleted stale transparency LUT cache file " << file;
+		}
+		else
+		{
+			Log(LOG_WARNING) << "Failed to delete stale transparency LUT cache file " << file;
+		}
+	}
+}
+
 StatAdjustment *Mod::getStatAdjustment(int difficulty)
 {
 	if ((size_t)difficulty >= MaxDifficultyLevels)
@@ -163,6 +163,7 @@ private:
 	std::map<std::string, Music*> _musics;
 	std::vector<Uint16> _voxelData;
 	std::vector<std::vector<Uint8> > _transparencyLUTs;
+	std::vector<std::string> _transparencyLUTCacheFiles;
 
 	std::map<std::string, RuleCountry*> _countries, _extraGlobeLabels;
 	std::map<std::string, RuleRegion*> _regions;
@@ -360,8 +361,12 @@ private:
 	void loadBattlescapeResources();
 	/// Loads a specified music file.
 	Music* loadMusic(MusicFormat fmt, RuleMusic* rule, CatFile* adlibcat, CatFile* aintrocat, GMCatFile* gmcat) const;
+	/// Gets the cache file name of a transparency lookup table for a given palette.
+	std::string getTransparencyLUTCacheFile(const SDL_Color* palColors) const;
 	/// Creates a transparency lookup table for a given palette.
 	void createTransparencyLUT(Palette *pal);
+	/// Deletes the cached transparency lookup tables the current mods don't use.
+	void pruneTransparencyLUTCache() const;
 	/// Loads a specified mod content.
 	void loadMod(const std::vector<FileMap::FileRecord> &rulesetFiles, ModScript &parsers);
 	/// Loads resources from vanilla.
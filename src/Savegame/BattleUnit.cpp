@@ -1576,6 +1576,10 @@ int BattleUnit::damage(Position relative, int damage, const RuleDamageType *type
 	UnitBodyPart bodypart = BODYPART_TORSO;
 
 	_hitByAnything = true;
+	if (getVisible())
+	{
+		save->markVisibleChange();
+	}
 	if (_health <= 0)
 	{
 		return 0;
@@ -95,6 +95,8 @@ private:
 	UnitFaction _side;
 	int _turn, _bughuntMinTurn;
 	int _animFrame;
+	Uint32 _tileChanges;
+	bool _visibleChange;
 	bool _nameDisplay;
 	bool _debugMode, _bughuntMode;
 	bool _aborted;
@@ -406,6 +408,16 @@ public:
 	int getAnimFrame() const;
 	/// Increase animation frame.
 	void nextAnimFrame();
+	/// Notes that something drawn on a tile changed.
+	void markTileChanged() { ++_tileChanges; }
+	/// Gets a count that changes whenever something drawn on a tile changes.
+	Uint32 getTileChanges() const { return _tileChanges; }
+	/// Notes that something the player can see changed.
+	void markVisibleChange() { _visibleChange = true; }
+	/// Checks if something the player can see changed since the last reset.
+	bool getVisibleChange() const { return _visibleChange; }
+	/// Resets the visible change flag.
+	void resetVisibleChange() { _visibleChange = false; }
 	/// Sets debug mode.
 	void setDebugMode();
 	void revealMap();
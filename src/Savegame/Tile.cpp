@@ -245,6 +245,7 @@ void Tile::saveBinary(Uint8** buffer) const
  */
 void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, TilePart part)
 {
+	_save->markTileChanged();
 	_objects[part] = dat;
 	_mapData->ID[part] = mapDataID;
 	_mapData->SetID[part] = mapDataSetID;
@@ -387,6 +388,7 @@ int Tile::getFootstepSound(Tile *tileBelow) const
  */
 int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bool rClick)
 {
+	_save->markTileChanged();
 	if (!_objects[part]) return -1;
 
 	BattleActionCost cost;
@@ -412,12 +414,14 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 		setMapData(_objects[part]->getDataset()->getObject(_objects[part]->getAltMCD()), _objects[part]->getAltMCD(), _mapData->SetID[part],
 				   _objects[part]->getDataset()->getObject(_objects[part]->getAltMCD())->getObjectType());
 		setMapData(0, -1, -1, part);
+		markSeenChange(part);
 		return 0;
 	}
 	if (_objectsCache[part].isUfoDoor && _objectsCache[part].currentFrame == 0) // ufo door part 0 - door is closed
 	{
 		if (unit && cost.Time && !cost.haveTU())
 			return 4;
+		markSeenChange(part);
 		_objectsCache[part].currentFrame = 1; // start opening door
 		updateSprite((TilePart)part);
 		return 1;
@@ -431,6 +435,7 @@ int Tile::openDoor(TilePart part, BattleUnit *unit, BattleActionType reserve, bo
 
 int Tile::closeUfoDoor()
 {
+	_save->markTileChanged();
 	int retval = 0;
 
 	for (int part = O_FLOOR; part <= O_NORTHWALL; ++part)
@@ -455,6 +460,7 @@ void Tile::setDiscovered(bool flag, TilePart part)
 {
 	if (_objectsCache[part].discovered != flag)
 	{
+		_save->markTileChanged();
 		_objectsCache[part].discovered = flag;
 		if (part == O_FLOOR && flag == true)
 		{
@@ -464,6 +470,19 @@ void Tile::setDiscovered(bool flag, TilePart part)
 	}
 }
 
+/**
+ * Notes a change to a part of this tile the player has already seen,
+ * so that it is not skipped over while fast forwarding a turn.
+ * @param part Tile part that changed.
+ */
+void Tile::markSeenChange(TilePart part)
+{
+	if (_objectsCache[part].discovered)
+	{
+		_save->markVisibleChange();
+	}
+}
+
 /**
  * Get the black fog of war state of this tile.
  * @param part Tile part
@@ -481,7 +500,11 @@ bool Tile::isDiscovered(TilePart part) const
  */
 void Tile::resetLight(LightLayers layer)
 {
-	_light[layer] = 0;
+	if (_light[layer] != 0)
+	{
+		_save->markTileChanged();
+		_light[layer] = 0;
+	}
 }
 
 /**
@@ -492,7 +515,11 @@ void Tile::resetLightMulti(LightLayers layer)
 {
 	for (int l = layer; l < LL_MAX; l++)
 	{
-		_light[l] = 0;
+		if (_light[l] != 0)
+		{
+			_save->markTileChanged();
+			_light[l] = 0;
+		}
 	}
 }
 
@@ -504,7 +531,10 @@ void Tile::resetLightMulti(LightLayers layer)
 void Tile::addLight(int light, LightLayers layer)
 {
 	if (_light[layer] < light)
+	{
+		_save->markTileChanged();
 		_light[layer] = light;
+	}
 }
 
 /**
@@ -692,6 +722,7 @@ int Tile::getFuel(TilePart part) const
  */
 void Tile::ignite(int power)
 {
+	_save->markTileChanged();
 	if (getFlammability() != 255)
 	{
 		power = power - (getFlammability() / 10) + 15;
@@ -784,6 +815,11 @@ BattleUnit *Tile::getOverlappingUnit(const SavedBattleGame *saveBattleGame, Tile
  */
 void Tile::setFire(int fire)
 {
+	_save->markTileChanged();
+	if (_fire != Clamp(fire, 0, 255))
+	{
+		markSeenChange(O_FLOOR);
+	}
 	_fire = Clamp(fire, 0, 255);
 	_animationOffset = RNG::generate(0,3);
 }
@@ -803,6 +839,8 @@ int Tile::getFire() const
  */
 void Tile::addSmoke(int smoke)
 {
+	_save->markTileChanged();
+	markSeenChange(O_FLOOR);
 	if (_fire == 0)
 	{
 		if (_overlaps == 0)
@@ -824,6 +862,11 @@ void Tile::addSmoke(int smoke)
  */
 void Tile::setSmoke(int smoke)
 {
+	_save->markTileChanged();
+	if (_smoke != Clamp(smoke, 0, 255))
+	{
+		markSeenChange(O_FLOOR);
+	}
 	_smoke = Clamp(smoke, 0, 255);
 	_animationOffset = RNG::generate(0,3);
 }
@@ -855,6 +898,7 @@ int Tile::getAnimationOffset() const
  */
 void Tile::addItem(BattleItem *item, const RuleInventory *ground)
 {
+	_save->markTileChanged();
 	item->setSlot(ground);
 	_inventory.push_back(item);
 	item->setTile(this);
@@ -872,6 +916,7 @@ void Tile::addItem(BattleItem *item, const RuleInventory *ground)
  */
 void Tile::removeItem(BattleItem *item)
 {
+	_save->markTileChanged();
 	for (auto iter = _inventory.begin(); iter != _inventory.end(); ++iter)
 	{
 		if ((*iter) == item)
@@ -951,6 +996,7 @@ static inline void applyEnvi(BattleUnit* unit, int smoke, int fire, bool smokeDa
  */
 void Tile::prepareNewTurn(bool smokeDamage)
 {
+	_save->markTileChanged();
 	// we've received new smoke in this turn, but we're not on fire, average out the smoke.
 	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
 	{
@@ -978,13 +1024,30 @@ std::vector<BattleItem *> *Tile::getInventory()
 }
 
 
+/**
+ * Set a unit on this tile.
+ * @param unit The unit, or nullptr.
+ */
+void Tile::setUnit(BattleUnit *unit)
+{
+	if (_unit != unit)
+	{
+		_save->markTileChanged();
+		_unit = unit;
+	}
+}
+
 /**
  * Set the marker color on this tile.
  * @param color
  */
 void Tile::setMarkerColor(int color)
 {
-	_markerColor = color;
+	if (_markerColor != color)
+	{
+		_save->markTileChanged();
+		_markerColor = color;
+	}
 }
 
 /**
@@ -1002,7 +1065,11 @@ int Tile::getMarkerColor() const
  */
 void Tile::setVisible(int visibility)
 {
-	_visible += visibility;
+	if (visibility != 0)
+	{
+		_save->markTileChanged();
+		_visible += visibility;
+	}
 }
 
 /**
@@ -1020,7 +1087,11 @@ int Tile::getVisible() const
  */
 void Tile::setPreview(int dir)
 {
-	_preview = dir;
+	if (_preview != dir)
+	{
+		_save->markTileChanged();
+		_preview = dir;
+	}
 }
 
 /**
@@ -1038,7 +1109,11 @@ int Tile::getPreview() const
  */
 void Tile::setTUMarker(int tu)
 {
-	_TUMarker = tu;
+	if (_TUMarker != tu)
+	{
+		_save->markTileChanged();
+		_TUMarker = tu;
+	}
 }
 
 /**
@@ -1056,7 +1131,11 @@ int Tile::getTUMarker() const
  */
 void Tile::setEnergyMarker(int energy)
 {
-       _EnergyMarker = energy;
+	if (_EnergyMarker != energy)
+	{
+		_save->markTileChanged();
+		_EnergyMarker = energy;
+	}
 }
 
 /**
@@ -1108,7 +1187,11 @@ bool Tile::getDangerous() const
  */
 void Tile::setObstacle(int part)
 {
-	_obstacle |= (1 << part);
+	if (!(_obstacle & (1 << part)))
+	{
+		_save->markTileChanged();
+		_obstacle |= (1 << part);
+	}
 }
 
 /**
@@ -1116,7 +1199,11 @@ void Tile::setObstacle(int part)
  */
 void Tile::resetObstacle(void)
 {
-	_obstacle = 0;
+	if (_obstacle != 0)
+	{
+		_save->markTileChanged();
+		_obstacle = 0;
+	}
 }
 
 void Tile::setLastExplored(UnitFaction faction)
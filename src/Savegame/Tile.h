@@ -141,6 +141,8 @@ protected:
 	int _lastExploredByHostile = 0;
 	int _lastExploredByNeutral = 0;
 
+	/// Notes a change to a part of this tile the player has already seen.
+	void markSeenChange(TilePart part);
 
 public:
 	/// Creates a tile.
@@ -338,13 +340,8 @@ public:
 		return _currentSurface[part];
 	}
 
-	/**
-	 * Set a unit on this tile.
-	 */
-	void setUnit(BattleUnit *unit)
-	{
-		_unit = unit;
-	}
+	/// Set a unit on this tile.
+	void setUnit(BattleUnit *unit);
 
 	/**
 	 * Get the (alive) unit on this tile.
@@ -825,13 +825,13 @@ void StatsForNerdsState::addVectorOfRulesNamed(std::ostringstream &ss, const std
 template<typename T, typename I>
 void StatsForNerdsState::addScriptTags(std::ostringstream &ss, const ScriptValues<T, I> &values)
 {
-	auto& tagValues = values.getValuesRaw();
+	auto tagValues = values.getValuesRaw();
 	ArgEnum index = ScriptParserBase::getArgType<ScriptTag<T, I>>();
 	auto tagNames = _game->getMod()->getScriptGlobal()->getTagNames().at(index);
 	for (size_t i = 0; i < tagValues.size(); ++i)
 	{
 		auto nameAsString = tagNames.values[i].name.toString().substr(4);
-		addIntegerScriptTag(ss, tagValues.at(i), nameAsString);
+		addIntegerScriptTag(ss, tagValues.begin()[i], nameAsString);
 	}
 }
 